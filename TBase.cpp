@@ -21,6 +21,16 @@
 
 #include "TBase.h"
 
+TClock *TBase::defaultClock = NULL;
+
+#ifdef ENABLE_LOOP_REGISTRY
+TBase *TBase::firstObject = NULL;
+TBase *TBase::lastObject = NULL;
+TBase::TBASE_CURSOR *TBase::loopCursor = NULL;
+unsigned long TBase::sharedMillis = 0;
+bool TBase::sharedLoop = false;
+#endif
+
 void TBase::defaults()
 {
 #ifdef TDUINO_DEBUG
@@ -34,22 +44,158 @@ void TBase::defaults()
 TBase::TBase()
 {
   defaults();
+#ifdef ENABLE_OBJECT_CLOCKS
+  this->clock = NULL;
+#endif
+#ifdef ENABLE_LOOP_REGISTRY
+  join();
+#endif
+}
+
+#ifdef ENABLE_LOOP_REGISTRY
+TBase::TBase(const TBase &other)
+{
+  *this = other;
+  join();
+}
+
+TBase &TBase::operator=(const TBase &other)
+{
+#ifdef TDUINO_DEBUG
+  this->attachedTo = other.attachedTo;
+#endif
+  this->loopMillis = other.loopMillis;
+#ifdef ENABLE_OBJECT_CLOCKS
+  this->clock = other.clock;
+#endif
+  return *this;
 }
 
+void TBase::join()
+{
+  this->nextObject = NULL;
+  if (lastObject) lastObject->nextObject = this;
+  else firstObject = this;
+  lastObject = this;
+}
+#endif
+
 TBase::~TBase()
 {
 #ifdef TDUINO_DEBUG
   if (this->attachedTo) this->attachedTo->detachFrom(this);
 #endif
+#ifdef ENABLE_LOOP_REGISTRY
+  TBase *prev = NULL;
+  for (TBase *obj = firstObject; obj; obj = obj->nextObject)
+  {
+    if (obj == this)
+    {
+      if (prev) prev->nextObject = this->nextObject;
+      else firstObject = this->nextObject;
+      if (lastObject == this) lastObject = prev;
+      for (TBASE_CURSOR *c = loopCursor; c; c = c->outer)
+        if (c->next == this) c->next = this->nextObject; //Destroyed during loopAll()
+      break;
+    }
+    prev = obj;
+  }
+#endif
+}
+
+unsigned long TBase::defaultNow()
+{
+  return defaultClock ? defaultClock->read() : TClock::hardware();
+}
+
+unsigned long TBase::now()
+{
+#ifdef ENABLE_OBJECT_CLOCKS
+  if (this->clock) return this->clock->read();
+#endif
+  return defaultNow();
+}
+
+#ifdef ENABLE_OBJECT_CLOCKS
+void TBase::setClock(TClock *clock)
+{
+  this->clock = clock;
+}
+#endif
+
+void TBase::setDefaultClock(TClock *clock)
+{
+  defaultClock = clock;
 }
 
 void TBase::loop() {
-#ifdef TIMING_WITH_MICROS
-  loopMillis = micros();
-#else 
-  loopMillis = millis();
+#ifdef ENABLE_LOOP_REGISTRY
+#ifdef ENABLE_OBJECT_CLOCKS
+  if (sharedLoop && !this->clock)
+#else
+  if (sharedLoop)
 #endif
-#ifdef TDUINO_DEBUG
-  loopMillis += TDUINO_SIMULATED_UPTIME;
+  {
+    loopMillis = sharedMillis;
+    return;
+  }
 #endif
+  loopMillis = now();
+}
+
+unsigned long TBase::nextDueIn()
+{
+  return 0;
 }
+
+unsigned long TBase::dueFromNow()
+{
+  unsigned long due = nextDueIn(), elapsed;
+  if (due == TDUINO_NOT_DUE) return due;
+  elapsed = now() - loopMillis;
+  return (due > elapsed) ? due - elapsed : 0;
+}
+
+unsigned long TBase::earliestDueIn(TBase *objects[], byte count)
+{
+  unsigned long earliest = TDUINO_NOT_DUE, due;
+  for (byte i = 0; (i < count) && (earliest > 0); i++)
+  {
+    due = objects[i]->dueFromNow();
+    if (due < earliest) earliest = due;
+  }
+  return earliest;
+}
+
+#ifdef ENABLE_LOOP_REGISTRY
+void TBase::loopAll()
+{
+  if (!firstObject) return;
+  TBASE_CURSOR cursor;
+  unsigned long outerMillis = sharedMillis;
+  bool outerLoop = sharedLoop;
+  cursor.outer = loopCursor;
+  loopCursor = &cursor;
+  sharedMillis = defaultNow();
+  sharedLoop = true;
+  for (TBase *obj = firstObject; obj; obj = cursor.next)
+  {
+    cursor.next = obj->nextObject;
+    obj->loop();
+  }
+  loopCursor = cursor.outer;
+  sharedMillis = outerMillis;
+  sharedLoop = outerLoop;
+}
+
+unsigned long TBase::earliestDueIn()
+{
+  unsigned long earliest = TDUINO_NOT_DUE, due;
+  for (TBase *obj = firstObject; obj && (earliest > 0); obj = obj->nextObject)
+  {
+    due = obj->dueFromNow();
+    if (due < earliest) earliest = due;
+  }
+  return earliest;
+}
+#endif
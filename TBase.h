@@ -22,7 +22,77 @@
 #ifndef TBASE_H
 #define TBASE_H
 
-#include "TDefs.h"
+#include "TClock.h"
+
+/**
+ * \brief Returned by TBase::nextDueIn() when an object has nothing scheduled.
+ */
+#define TDUINO_NOT_DUE ((unsigned long)-1)
+
+/**
+ * \brief Timing policy: a late event is timed from the time it is handled, missed periods are lost.
+ */
+#define TDUINO_TIMING_BEST_EFFORT 0
+
+/**
+ * \brief Timing policy: events are timed from their deadline and missed periods are caught up.
+ */
+#define TDUINO_TIMING_TIGHT 1
+
+/**
+ * \brief Timing policy: same as #TDUINO_TIMING_TIGHT with a limit on the missed periods caught up.
+ */
+#define TDUINO_TIMING_CAPPED 2
+
+/**
+ * \brief The timing policy used until another policy is set, see ENABLE_TIGHT_TIMING.
+ */
+#ifdef ENABLE_TIGHT_TIMING
+  #define TDUINO_TIMING_DEFAULT TDUINO_TIMING_TIGHT
+#else
+  #define TDUINO_TIMING_DEFAULT TDUINO_TIMING_BEST_EFFORT
+#endif
+
+/**
+ * \brief Binds a method of a class to a handler taking a context.
+ * 
+ * Handlers of TTimer and TTimeline (see TTimer::setHandler() and TTimeline::setHandler())
+ * receive a context pointer which is passed as the first argument. TDuino_Method creates
+ * a handler which calls _METHOD_ on the object given as context:
+ * 
+ * \code
+ * class TBlinker
+ * {
+ * public:
+ *   void tick(byte index) { ... }
+ * };
+ * 
+ * TBlinker blinker;
+ * timer.setHandler(0, TDuino_Method<TBlinker, &TBlinker::tick>, &blinker);
+ * \endcode
+ */
+template <class T, void (T::*METHOD)(byte)> void TDuino_Method(void *context, byte index)
+{
+  (((T*)context)->*METHOD)(index);
+}
+
+/**
+ * \overload TDuino_Method(void *context, byte index, float progress)
+ * \brief Binds a method to a TTimeline handler.
+ */
+template <class T, void (T::*METHOD)(byte, float)> void TDuino_Method(void *context, byte index, float progress)
+{
+  (((T*)context)->*METHOD)(index, progress);
+}
+
+/**
+ * \overload TDuino_Method(void *context, byte index, unsigned int progress)
+ * \brief Binds a method to a TTimeline handler using fixed point progress.
+ */
+template <class T, void (T::*METHOD)(byte, unsigned int)> void TDuino_Method(void *context, byte index, unsigned int progress)
+{
+  (((T*)context)->*METHOD)(index, progress);
+}
 
 /**
  * \brief Base class for all classes in TDuino.
@@ -64,10 +134,44 @@ private:
   friend class TList;
 #endif
 
+#ifdef ENABLE_LOOP_REGISTRY
+private:
+  //The position of a pass of loopAll(), passes may be nested
+  struct TBASE_CURSOR
+  {
+    TBase *next;
+    TBASE_CURSOR *outer;
+  };
+  TBase *nextObject;
+  static TBase *firstObject, *lastObject;
+  static TBASE_CURSOR *loopCursor;
+  static unsigned long sharedMillis;
+  static bool sharedLoop;
+  void join();
+#endif
+
+private:
+#ifdef ENABLE_OBJECT_CLOCKS
+  TClock *clock;
+#endif
+  static TClock *defaultClock;
+  static unsigned long defaultNow();
+  unsigned long dueFromNow();
+
 protected:
 
   unsigned long loopMillis; //!< The value of millis() to be used within loop()
   
+  /**
+   * \brief Get the current time.
+   * \return The current time of the clock used by the object.
+   * 
+   * Used to read the clock in the same way as loop() does when it updates #loopMillis.
+   * 
+   * \see setClock()
+   */
+  unsigned long now();
+  
   /**
    * \brief Method used to reset all class internal variables.
    * 
@@ -113,6 +217,22 @@ public:
 	*/
   TBase();
   
+#ifdef ENABLE_LOOP_REGISTRY
+  /**
+   * \brief Copy constructor for class TBase.
+   * 
+   * The copy joins the registry on its own, so it is looped by loopAll() as well.
+   */
+  TBase(const TBase &other);
+  
+  /**
+   * \brief Assignment for class TBase.
+   * 
+   * Everything but the position in the registry is copied.
+   */
+  TBase &operator=(const TBase &other);
+#endif
+  
   /**
 	* \brief Destructor for class TBase.
 	* 
@@ -127,6 +247,96 @@ public:
 	*/
   virtual void loop();
   
+  /**
+   * \brief Get the time until the object needs to be looped again.
+   * \return Milliseconds (or microseconds) until loop() must be called or TDUINO_NOT_DUE.
+   * 
+   * The returned value is relative to the last call to loop() and it tells how long it
+   * will take before calling loop() will have any effect. A value of zero means that
+   * loop() should be called as often as possible (eg. a transition is in progress or a
+   * pin is being polled) and TDUINO_NOT_DUE means that nothing is scheduled at all. The
+   * default implementation returns zero, subclasses which knows better should override it.
+   * 
+   * \see earliestDueIn()
+   */
+  virtual unsigned long nextDueIn();
+  
+  /**
+   * \brief Get the time until any of the given objects needs to be looped again.
+   * \param objects The objects to examine.
+   * \param count The number of objects.
+   * \return Milliseconds (or microseconds) from now until loop() must be called or TDUINO_NOT_DUE.
+   * 
+   * Finds the earliest value returned by nextDueIn() for the objects and subtracts the time
+   * which has elapsed since each of the objects was looped. This can be used to let the
+   * sketch sleep or do other work until one of the objects needs attention:
+   * 
+   * \code
+   * TBase *objects[] = { &timer, &timeline, &led, button.asBase() };
+   * 
+   * void loop()
+   * {
+   *   timer.loop();
+   *   timeline.loop();
+   *   led.loop();
+   *   button.loop();
+   *   unsigned long idle = TBase::earliestDueIn(objects, 4);
+   *   if (idle > 10) doSomethingElse(idle);
+   * }
+   * \endcode
+   */
+  static unsigned long earliestDueIn(TBase *objects[], byte count);
+  
+#ifdef ENABLE_OBJECT_CLOCKS
+  /**
+   * \brief Set the clock used by the object.
+   * \param clock The clock to use or NULL to use the default clock.
+   * 
+   * Changing the clock of an object which is running may cause it to trigger events too
+   * early or too late, so the clock should be set during setup() before the object is used.
+   * 
+   * Only available if ENABLE_OBJECT_CLOCKS is defined, see \ref tduino_tweaks.
+   * 
+   * \see TClock, setDefaultClock()
+   */
+  void setClock(TClock *clock);
+#endif
+  
+  /**
+   * \brief Set the clock used by all objects which has no clock of their own.
+   * \param clock The clock to use or NULL to use millis() (or micros()).
+   * 
+   * \see TClock, setClock()
+   */
+  static void setDefaultClock(TClock *clock);
+  
+#ifdef ENABLE_LOOP_REGISTRY
+  /**
+   * \brief Loop all objects.
+   * 
+   * Calls loop() for every object in the registry in the order in which they were
+   * constructed. The default clock is read once and all objects without a clock of their
+   * own will use that time as their #loopMillis. Objects which are looped by loopAll() should not be looped elsewhere.
+   * 
+   * Objects may be constructed or destroyed by the objects being looped. loopAll() may
+   * also be called by an object being looped (eg. from a callback waiting for something),
+   * the nested call loops all objects, including the one which called it, using a new
+   * reading of the clock and the outer call continues with the next object afterwards.
+   * 
+   * Only available if ENABLE_LOOP_REGISTRY is defined, see \ref tduino_tweaks.
+   */
+  static void loopAll();
+  
+  /**
+   * \brief Get the time until any object in the registry needs to be looped again.
+   * 
+   * Same as earliestDueIn(TBase *objects[], byte count) for all objects in the registry.
+   * 
+   * Only available if ENABLE_LOOP_REGISTRY is defined, see \ref tduino_tweaks.
+   */
+  static unsigned long earliestDueIn();
+#endif
+  
 };
 
 #endif //TBASE_H
@@ -21,6 +21,8 @@
 
 #include "TButton.h"
 
+#define LONG_BIT 128 //Set in "clicks" when a long press has been reported
+
 void TButton::defaults()
 {
   TPinInput::defaults();
@@ -32,14 +34,26 @@ void TButton::defaults()
   delay1 = 0;
   delay2 = 0;
   lastRepeat = 0;
+  setClick(250, 800);
+  clickCallback = NULL;
+  longCallback = NULL;
+  clicks = 0;
 }
 
 void TButton::falling()
 {
-  lastRepeat = loopMillis;
+  lastRepeat = changeMillis; //Updated by TPinInput before the event
   TPinInput::falling();
 }
 
+void TButton::rising()
+{
+  //A short press counts as a click, a long press has already been reported
+  if (clicks & LONG_BIT) clicks = 0;
+  else if (clickCallback && (clicks < 127)) clicks++;
+  TPinInput::rising();
+}
+
 TButton::TButton()
 {
   defaults();
@@ -73,9 +87,71 @@ void TButton::onRelease(TPinInputCallback callback)
   TPinInput::onRising(callback);
 }
 
+void TButton::setClick(unsigned int clickWindow, unsigned int longPress)
+{
+#ifdef TIMING_WITH_MICROS
+  this->clickWindow = clickWindow * 1000UL;
+  this->longDelay = longPress * 1000UL;
+#else
+  this->clickWindow = clickWindow;
+  this->longDelay = longPress;
+#endif
+}
+
+void TButton::onClick(TButtonClickCallback callback)
+{
+  clickCallback = callback;
+  clicks = 0;
+}
+
+void TButton::onLongPress(TPinInputCallback callback)
+{
+  longCallback = callback;
+}
+
+unsigned long TButton::nextDueIn()
+{
+  unsigned long due = TPinInput::nextDueIn(), e;
+  if (due == 0) return 0; //Polled or an edge is pending
+  if ((lastState == LOW) && (delay1 | delay2))
+  {
+    e = (lastRepeat == changeMillis) ? delay1 : delay2;
+    e = (loopMillis - lastRepeat >= e) ? 0 : e - (loopMillis - lastRepeat);
+    if (e < due) due = e;
+  }
+  if ((clickCallback || longCallback) && !(clicks & LONG_BIT) && ((lastState == LOW) || clicks))
+  {
+    //Waiting for the press to become a long press or the click window to close
+    e = (lastState == LOW) ? longDelay : clickWindow;
+    e = (loopMillis - changeMillis >= e) ? 0 : e - (loopMillis - changeMillis);
+    if (e < due) due = e;
+  }
+  return due;
+}
+
 void TButton::loop()
 {
   TPinInput::loop();
   //if pressed and use-delay and elapsed-since-last-repeat > delay then call falling()
-  if ((lastState == LOW) && (delay1 | delay2) && (loopMillis - lastRepeat >= ((lastRepeat == changeMillis) ? delay1 : delay2))) falling();
+  if ((lastState == LOW) && (delay1 | delay2) && (loopMillis - lastRepeat >= ((lastRepeat == changeMillis) ? delay1 : delay2)))
+  {
+    lastRepeat = loopMillis;
+    TPinInput::falling();
+  }
+  //While the button is down, the last change is the time of the press and while it is
+  //up, the last change is the time of the release
+  if (lastState == LOW)
+  {
+    if ((clickCallback || longCallback) && !(clicks & LONG_BIT) && (loopMillis - changeMillis >= longDelay))
+    {
+      clicks = LONG_BIT; //A long press ends any clicks
+      if (longCallback) longCallback(pin, LOW);
+    }
+  }
+  else if (clicks && (loopMillis - changeMillis >= clickWindow))
+  {
+    byte count = clicks;
+    clicks = 0;
+    clickCallback(pin, count);
+  }
 }
@@ -23,6 +23,11 @@
 #define TBUTTON_H
 #include "TPinInput.h"
 
+/**
+ * \brief The callback type used for clicks, receives the pin and the number of clicks.
+ */
+typedef void (*TButtonClickCallback)(byte, byte);
+
 /**
  * \brief Handles simple push buttons.
  * 
@@ -36,13 +41,17 @@ class TButton : protected TPinInput {
 
 private:
   unsigned int delay1, delay2;
-  unsigned long lastRepeat;
+  unsigned long clickWindow, longDelay, lastRepeat;
+  TButtonClickCallback clickCallback;
+  TPinInputCallback longCallback;
+  byte clicks;
   using TPinInput::setDeviation;
 
 protected:
 /// \cond HIDDEN_FIELD
   virtual void defaults();
   virtual void falling();
+  virtual void rising();
 /// \endcond
   
 public:
@@ -107,16 +116,92 @@ public:
 	* \see onPress()
 	*/
   void onRelease(TPinInputCallback callback);
+  
+  /**
+	* \brief Sets the timing used to detect clicks and long presses.
+	* 
+	* \param clickWindow Max. time (in milliseconds) from a release to the next press for them to be counted as one gesture.
+	* \param longPress Time (in milliseconds) the button must be held to be a long press.
+	* 
+	* A short press (released before _longPress_) counts as a click. When no new press
+	* has followed within _clickWindow_ after the last release, onClick() is called with
+	* the number of clicks, so a double click is reported as 2 clicks and so on. Holding
+	* the button for _longPress_ calls onLongPress() while the button is still pressed and
+	* the gesture ends (any clicks before it are discarded). The default is 250 / 800.
+	* The times are always given in milliseconds, also if TIMING_WITH_MICROS is defined.
+	* 
+	* Presses and releases are still reported by onPress() and onRelease(). No extra
+	* memory or timers are used, the gestures are tracked with the time of the last
+	* state change of the button.
+	* 
+	* \see onClick() onLongPress()
+	*/
+  void setClick(unsigned int clickWindow, unsigned int longPress);
+  
+  /**
+	* \brief Set the callback used for clicks.
+	* 
+	* \param callback The callback to be used for clicks.
+	* 
+	* The arguments passed to the callback are the pin number and the number of
+	* clicks (1 = single click, 2 = double click, 3 = triple click...).
+	* 
+	* \code
+	* void buttonClick(byte pin, byte clicks)
+	* {
+	*   if (clicks == 2) led.flip();
+	* }
+	* \endcode
+	* 
+	* \see setClick() onLongPress()
+	*/
+  void onClick(TButtonClickCallback callback);
+  
+  /**
+	* \brief Set the callback used for long presses.
+	* 
+	* \param callback The callback to be used for long presses.
+	* 
+	* The callback is invoked once when the button has been held for the time given
+	* with setClick(). The arguments are the pin number and the pins state (LOW).
+	* 
+	* \see setClick() onClick()
+	*/
+  void onLongPress(TPinInputCallback callback);
 
   /**
 	* \brief The buttons loop phase.
    * 
-   * Extends the functionality of TPinInput with a repeat functionality.
+   * Extends the functionality of TPinInput with repeats and gestures.
    * 
-   * \see TPinInput::loop() setRepeat()
+   * \see TPinInput::loop() setRepeat() setClick()
 	*/
   virtual void loop();
   
+  /**
+   * \brief Get the time until the button needs to be looped again.
+   * 
+   * A button which is polled must be looped all the time, so zero is returned unless
+   * the debounce has not elapsed. If the interrupt is used (setInterrupt(), requires
+   * ENABLE_PIN_INTERRUPTS), the time until the next repeat, long press or the end of
+   * the click window is returned and TDUINO_NOT_DUE if nothing is pending.
+   * 
+   * \see TPinInput::nextDueIn() TBase::nextDueIn()
+   */
+  virtual unsigned long nextDueIn();
+  
+  /**
+   * \brief Get the button as a TBase.
+   * 
+   * TButton hides the methods of TPinInput, so a TButton cannot be converted to a TBase
+   * outside the class. Use this to add a button to the objects used with TBase::earliestDueIn():
+   * 
+   * \code
+   * TBase *objects[] = { &timer, button.asBase() };
+   * \endcode
+   */
+  TBase *asBase() { return this; }
+  
   /**
 	* \brief Get the debounce for the button.
 	* \see TPinInput::getDebounce()
@@ -129,6 +214,15 @@ public:
 	*/
   using TPinInput::setDebounce;
   
+#ifdef ENABLE_PIN_INTERRUPTS
+  /**
+	* \brief Enable / disable interrupt driven edge capture for the button.
+	* \note Only available if ENABLE_PIN_INTERRUPTS is defined.
+	* \see TPinInput::setInterrupt()
+	*/
+  using TPinInput::setInterrupt;
+#endif
+  
 };
 
 #endif
@@ -0,0 +1,183 @@
+/*
+  
+  Copyright © 2018 - Torben Bruchhaus
+  TDuino.bruchhaus.dk - github.com/bswebdk/TDuino
+  File: TButtonBank.cpp
+  
+  This program is free software: you can redistribute it and/or modify
+  it under the terms of the GNU Lesser General Public License as published
+  by the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+  
+  This program is distributed in the hope that it will be useful, but
+  WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+  Lesser General Public License for more details.
+  
+  You should have received a copy of the GNU Lesser General Public License
+  along with this program.  If not, see <http://www.gnu.org/licenses/>
+  
+*/
+
+#include "TButtonBank.h"
+
+#define NO_REPEAT 255
+
+void TButtonBank::defaults()
+{
+  TBase::defaults();
+  this->callbacks[0] = NULL;
+  this->callbacks[1] = NULL;
+  this->state = 0;
+  this->count0 = 0;
+  this->count1 = 0;
+  this->lastSample = 0;
+  this->lastRepeat = 0;
+#ifdef TIMING_WITH_MICROS
+  this->debounce = 20000;
+#else
+  this->debounce = 20;
+#endif
+  this->delay1 = 0;
+  this->delay2 = 0;
+  this->repeatIndex = NO_REPEAT;
+  this->firstRepeat = false;
+}
+
+TButtonBank::TButtonBank()
+{
+  defaults();
+}
+
+void TButtonBank::attach(const byte pins[], byte count)
+{
+  group.attach(pins, count, INPUT_PULLUP);
+  state = 0;
+  count0 = 0;
+  count1 = 0;
+  repeatIndex = NO_REPEAT;
+  lastSample = now();
+}
+
+byte TButtonBank::getSize()
+{
+  return group.getSize();
+}
+
+byte TButtonBank::getPin(byte index)
+{
+  return group.getPin(index);
+}
+
+bool TButtonBank::isPressed(byte index)
+{
+#ifdef TDUINO_DEBUG
+  if (index >= group.getSize())
+  {
+    TDuino_Error(TDUINO_ERROR_BAD_LIST_INDEX, index, PSTR("TButtonBank::isPressed"));
+    return false;
+  }
+#endif
+  return (state >> index) & 1;
+}
+
+unsigned long TButtonBank::getPressed()
+{
+  return state;
+}
+
+unsigned int TButtonBank::getDebounce()
+{
+  return debounce;
+}
+
+void TButtonBank::setDebounce(unsigned int debounce)
+{
+#ifdef TDUINO_DEBUG
+  if (debounce < 4) TDuino_Error(TDUINO_ERROR_BAD_PARAMETER, debounce, PSTR("TButtonBank::setDebounce"));
+#endif
+  this->debounce = (debounce < 4) ? 4 : debounce;
+}
+
+void TButtonBank::setRepeat(unsigned int firstDelay, unsigned int followingDelay)
+{
+  delay1 = firstDelay;
+  delay2 = followingDelay;
+}
+
+void TButtonBank::onPress(TPinInputCallback callback)
+{
+  callbacks[0] = callback;
+}
+
+void TButtonBank::onRelease(TPinInputCallback callback)
+{
+  callbacks[1] = callback;
+}
+
+void TButtonBank::sample()
+{
+  byte size = group.getSize(), i;
+  //Buttons whose pin differs from the debounced state (a pressed button reads LOW)
+  unsigned long delta = ~group.read() ^ state;
+  if (size < 32) delta &= (1UL << size) - 1;
+  
+  //Vertical counter: each bit pair counts the reads in a row which differs from the state
+  //and the counter is reset whenever a read matches the state. When a counter wraps after
+  //four reads, the state of the button is changed.
+  count1 = (count1 ^ count0) & delta;
+  count0 = ~count0 & delta;
+  delta &= ~(count0 | count1);
+  if (!delta) return;
+  state ^= delta;
+  
+  for (i = 0; delta; i++, delta >>= 1)
+  {
+    if (!(delta & 1)) continue;
+    if ((state >> i) & 1)
+    {
+      repeatIndex = i;
+      firstRepeat = true;
+      lastRepeat = loopMillis;
+      if (callbacks[0]) callbacks[0](group.getPin(i), LOW);
+    }
+    else
+    {
+      if (repeatIndex == i) repeatIndex = NO_REPEAT;
+      if (callbacks[1]) callbacks[1](group.getPin(i), HIGH);
+    }
+  }
+}
+
+unsigned long TButtonBank::nextDueIn()
+{
+  unsigned long e = loopMillis - lastSample, due = debounce >> 2;
+  due = (e >= due) ? 0 : due - e;
+  if ((due > 0) && (repeatIndex != NO_REPEAT) && (delay1 | delay2))
+  {
+    e = firstRepeat ? delay1 : delay2;
+    e = (loopMillis - lastRepeat >= e) ? 0 : e - (loopMillis - lastRepeat);
+    if (e < due) due = e;
+  }
+  return due;
+}
+
+void TButtonBank::loop()
+{
+  TBase::loop();
+  if (loopMillis - lastSample >= (debounce >> 2))
+  {
+  #ifdef ENABLE_TIGHT_TIMING
+    lastSample += debounce >> 2;
+  #else
+    lastSample = loopMillis;
+  #endif
+    sample();
+  }
+  if ((repeatIndex != NO_REPEAT) && (delay1 | delay2) && (loopMillis - lastRepeat >= (firstRepeat ? delay1 : delay2)))
+  {
+    lastRepeat = loopMillis;
+    firstRepeat = false;
+    if (callbacks[0]) callbacks[0](group.getPin(repeatIndex), LOW);
+  }
+}
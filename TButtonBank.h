@@ -0,0 +1,195 @@
+/*
+  
+  Copyright © 2018 - Torben Bruchhaus
+  TDuino.bruchhaus.dk - github.com/bswebdk/TDuino
+  File: TButtonBank.h
+  
+  This program is free software: you can redistribute it and/or modify
+  it under the terms of the GNU Lesser General Public License as published
+  by the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+  
+  This program is distributed in the hope that it will be useful, but
+  WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+  Lesser General Public License for more details.
+  
+  You should have received a copy of the GNU Lesser General Public License
+  along with this program.  If not, see <http://www.gnu.org/licenses/>
+  
+*/
+
+#ifndef TBUTTONBANK_H
+#define TBUTTONBANK_H
+#include "TPinGroup.h"
+#include "TPinInput.h"
+
+/**
+ * \brief Handles up to 32 push buttons at once.
+ * 
+ * TButtonBank does the same as an array of TButton's but the buttons are read with a
+ * TPinGroup and debounced together using a two bit vertical counter for each button,
+ * so the cost of loop() is (almost) the same for one and 32 buttons. Callbacks are only
+ * made for the buttons which have changed.
+ * 
+ * A button must be read four times in a row with the same (new) state in order to change
+ * state, and the buttons are read each time a quarter of the debounce has elapsed. The
+ * default debounce is 20 milliseconds, just as for TButton.
+ * 
+ * \code
+ * const byte BUTTON_PINS[] = { 2, 3, 4, 5, 6, 7, 8, 9 };
+ * TButtonBank buttons;
+ * 
+ * void buttonPress(byte pin, int state)
+ * {
+ *   //React to the button on "pin" being pressed
+ * }
+ * 
+ * void setup()
+ * {
+ *   buttons.attach(BUTTON_PINS, 8);
+ *   buttons.onPress(buttonPress);
+ * }
+ * 
+ * void loop()
+ * {
+ *   buttons.loop();
+ * }
+ * \endcode
+ * 
+ * Using ENABLE_DIRECT_PORT_IO (see \ref tduino_tweaks) is recommended, since the
+ * buttons will then be read with one access per port.
+ * 
+ * \see TButton TPinGroup
+ */
+class TButtonBank : public TBase {
+
+private:
+
+  TPinGroup group;
+  TPinInputCallback callbacks[2];
+  unsigned long state, count0, count1, lastSample, lastRepeat;
+  unsigned int debounce, delay1, delay2;
+  byte repeatIndex;
+  bool firstRepeat;
+  
+  void sample();
+
+protected:
+
+/// \cond HIDDEN_FIELD
+  virtual void defaults();
+/// \endcond
+
+public:
+
+  /**
+   * \brief Default constructor for TButtonBank.
+   * 
+   * You MUST call attach() before the bank is of any use.
+   */
+  TButtonBank();
+  
+  /**
+   * \brief Attach the bank to a set of pins.
+   * \param pins The pins with buttons attached.
+   * \param count The number of pins (1..32).
+   * 
+   * The pins are set to INPUT_PULLUP, so the buttons must pull the pins to GND when
+   * pressed. All buttons are assumed to be released.
+   * 
+   * \see TPinGroup::attach()
+   */
+  void attach(const byte pins[], byte count);
+  
+  /**
+   * \brief Get the number of buttons in the bank.
+   */
+  byte getSize();
+  
+  /**
+   * \brief Get the pin of a button.
+   * \param index The index of the button.
+   * \return The pin number.
+   */
+  byte getPin(byte index);
+  
+  /**
+   * \brief Detects if a button is pressed / down.
+   * \param index The index of the button.
+   * \return True if the button is pressed / down.
+   */
+  bool isPressed(byte index);
+  
+  /**
+   * \brief Get the state of all the buttons.
+   * \return The buttons which are pressed, bit 0 is the first button.
+   */
+  unsigned long getPressed();
+  
+  /**
+   * \brief Get the amount of debounce used for the buttons.
+   * \see setDebounce()
+   */
+  unsigned int getDebounce();
+  
+  /**
+   * \brief Set the amount of debounce used for the buttons.
+   * \param debounce The debounce to use (4 or above).
+   * 
+   * The buttons are read each time debounce / 4 has elapsed, so a button will
+   * change state between debounce and 1.25 * debounce after the pin has settled.
+   */
+  void setDebounce(unsigned int debounce);
+  
+  /**
+   * \brief Sets the repeat rate for the buttons.
+   * \param firstDelay Delay (in milliseconds) before the first repeat.
+   * \param followingDelay Delay used for sub-sequent repeats.
+   * 
+   * Same as TButton::setRepeat() except that only the most recently pressed button
+   * repeats, just like the keyboard of a computer. If both arguments are zero (the
+   * default), no repeats will be generated.
+   */
+  void setRepeat(unsigned int firstDelay, unsigned int followingDelay);
+  
+  /**
+   * \brief Set the callback used for presses.
+   * \param callback The callback to use.
+   * 
+   * The arguments passed to the callback are the pin of the button and LOW.
+   * 
+   * \see TButton::onPress()
+   */
+  void onPress(TPinInputCallback callback);
+  
+  /**
+   * \brief Set the callback used for releases.
+   * \param callback The callback to use.
+   * 
+   * The arguments passed to the callback are the pin of the button and HIGH.
+   * 
+   * \see TButton::onRelease()
+   */
+  void onRelease(TPinInputCallback callback);
+  
+  /**
+   * \brief Get the time until the bank needs to be looped again.
+   * 
+   * This is the time until the buttons are to be read again or a repeat is due.
+   * 
+   * \see TBase::nextDueIn()
+   */
+  virtual unsigned long nextDueIn();
+  
+  /**
+   * \brief The bank's loop method.
+   * 
+   * Must be called in order to read the buttons. If loop() is not called, no
+   * events will be triggered.
+   */
+  virtual void loop();
+
+};
+
+#endif //TBUTTONBANK_H
@@ -0,0 +1,86 @@
+/*
+  
+  Copyright © 2018 - Torben Bruchhaus
+  TDuino.bruchhaus.dk - github.com/bswebdk/TDuino
+  File: TClock.cpp 
+  
+  This program is free software: you can redistribute it and/or modify
+  it under the terms of the GNU Lesser General Public License as published
+  by the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+  
+  This program is distributed in the hope that it will be useful, but
+  WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+  Lesser General Public License for more details.
+  
+  You should have received a copy of the GNU Lesser General Public License
+  along with this program.  If not, see <http://www.gnu.org/licenses/>
+  
+*/
+
+#include "TClock.h"
+
+TClock::~TClock()
+{
+}
+
+unsigned long TClock::hardware()
+{
+#ifdef TIMING_WITH_MICROS
+  unsigned long t = micros();
+#else 
+  unsigned long t = millis();
+#endif
+#ifdef TDUINO_DEBUG
+  t += TDUINO_SIMULATED_UPTIME;
+#endif
+  return t;
+}
+
+TClockVirtual::TClockVirtual(unsigned long start)
+{
+  this->time = start;
+}
+
+unsigned long TClockVirtual::read()
+{
+  return this->time;
+}
+
+void TClockVirtual::set(unsigned long time)
+{
+  this->time = time;
+}
+
+void TClockVirtual::advance(unsigned long amount)
+{
+  this->time += amount;
+}
+
+TClockCached::TClockCached(TClock *source)
+{
+  this->source = source;
+  update();
+}
+
+unsigned long TClockCached::read()
+{
+#ifdef __AVR__
+  //update() may be called from an ISR, so the four bytes must be read with interrupts
+  //disabled. The interrupt state is restored rather than enabled, read() may be used in an ISR.
+  unsigned long t;
+  byte oldSREG = SREG;
+  cli();
+  t = this->time;
+  SREG = oldSREG;
+  return t;
+#else
+  return this->time; //A single load on 32 bit boards
+#endif
+}
+
+void TClockCached::update()
+{
+  this->time = this->source ? this->source->read() : TClock::hardware();
+}
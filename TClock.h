@@ -0,0 +1,163 @@
+/*
+  
+  Copyright © 2018 - Torben Bruchhaus
+  TDuino.bruchhaus.dk - github.com/bswebdk/TDuino
+  File: TClock.h   
+  
+  This program is free software: you can redistribute it and/or modify
+  it under the terms of the GNU Lesser General Public License as published
+  by the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+  
+  This program is distributed in the hope that it will be useful, but
+  WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+  Lesser General Public License for more details.
+  
+  You should have received a copy of the GNU Lesser General Public License
+  along with this program.  If not, see <http://www.gnu.org/licenses/>
+  
+*/
+
+#ifndef TCLOCK_H
+#define TCLOCK_H
+
+#include "TDefs.h"
+
+/**
+ * \brief Base class for clock sources used by TDuino.
+ * 
+ * By default all objects in TDuino reads the time from millis() (or micros() if
+ * TIMING_WITH_MICROS is defined). A clock source can be assigned to all objects with
+ * TBase::setDefaultClock() or to a single object with TBase::setClock() (if
+ * ENABLE_OBJECT_CLOCKS is defined) in order to read the time from somewhere else, eg. a hardware timer or a virtual clock.
+ * 
+ * To create your own clock source you should subclass TClock and implement read():
+ * 
+ * \code
+ * class TRtcClock : public TClock
+ * {
+ * public:
+ *   virtual unsigned long read() { return rtc.now().unixtime(); } //Seconds
+ * };
+ * \endcode
+ * 
+ * The value returned by read() must increase by one for each tick and roll over from
+ * 0xFFFFFFFF to zero, just like millis(). A 16 bit counter (eg. TCNT1 of an AVR) cannot
+ * be used directly, it must be extended to 32 bits by counting its overflows.
+ */
+class TClock {
+
+public:
+
+  /**
+   * \brief Destructor for class TClock.
+   * 
+   * Does nothing else than implement a virtual destructor.
+   */
+  virtual ~TClock();
+
+  /**
+   * \brief Read the clock.
+   * \return The current time of the clock.
+   */
+  virtual unsigned long read() = 0;
+  
+  /**
+   * \brief Read the hardware clock.
+   * \return The current value of millis() (or micros()).
+   * 
+   * This is the clock used by TDuino when no clock source has been assigned. If
+   * TDUINO_DEBUG is defined, TDUINO_SIMULATED_UPTIME will be added to the value.
+   */
+  static unsigned long hardware();
+  
+};
+
+/**
+ * \brief A virtual clock which only moves when told to.
+ * 
+ * TClockVirtual can be used to run TDuino deterministically and much faster than
+ * real time, eg. when testing how a sketch handles the 32 bit rollover:
+ * 
+ * \code
+ * TClockVirtual clock(0xFFFFFF00UL);
+ * 
+ * void setup()
+ * {
+ *   TBase::setDefaultClock(&clock);
+ * }
+ * 
+ * void loop()
+ * {
+ *   timer.loop();
+ *   clock.advance(1);
+ * }
+ * \endcode
+ */
+class TClockVirtual : public TClock {
+
+protected:
+
+  unsigned long time; ///< The current time of the clock.
+
+public:
+
+  /**
+   * \brief Constructor for class TClockVirtual.
+   * \param start The initial time of the clock.
+   */
+  TClockVirtual(unsigned long start = 0);
+  
+  virtual unsigned long read();
+  
+  /**
+   * \brief Set the time of the clock.
+   * \param time The new time.
+   */
+  void set(unsigned long time);
+  
+  /**
+   * \brief Move the clock forward.
+   * \param amount The number of ticks to move the clock.
+   */
+  void advance(unsigned long amount);
+  
+};
+
+/**
+ * \brief A clock which caches the time of another clock.
+ * 
+ * Reading TClockCached does not read the source clock. The cached time is only changed
+ * when update() is called, eg. once in the beginning of loop() or from an interrupt
+ * service routine. Since update() may be called from an interrupt, read() disables
+ * interrupts while the cached time is copied on AVR boards (and restores the previous
+ * state, so read() can be used from an interrupt as well).
+ */
+class TClockCached : public TClock {
+
+protected:
+
+  TClock *source; ///< The clock to be cached or NULL for the hardware clock.
+  volatile unsigned long time; ///< The cached time.
+
+public:
+
+  /**
+   * \brief Constructor for class TClockCached.
+   * \param source The clock to be cached or NULL for the hardware clock.
+   */
+  TClockCached(TClock *source = NULL);
+  
+  virtual unsigned long read();
+  
+  /**
+   * \brief Update the cached time from the source clock.
+   * 
+   * Safe to call from an interrupt service routine.
+   */
+  void update();
+  
+};
+
+#endif //TCLOCK_H
@@ -63,6 +63,8 @@ int freeRam () {
   return (int) &v - (__brkval == 0 ? (int) &__heap_start : (int) __brkval);
 #elif defined(ARDUINO_ESP8266_NODEMCU)
   return node.heap();
+#elif defined(TDUINO_HOST)
+  return 1000; //Built with the host shim in extras/host
 #else
   #warning "Could not detect proper board type in TDefs::freeRam()"
   return 1000; //Assumed maximum available memory
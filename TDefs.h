@@ -46,6 +46,41 @@
 //Uncomment to enable floating point math for sampling in TPinInput
 //#define TPININPUT_FLOAT_MATH
 
+//Uncomment to let all objects join a registry which allows TBase::loopAll() to be used
+//#define ENABLE_LOOP_REGISTRY
+
+//Uncomment to allow each object to use its own clock (TBase::setClock())
+//#define ENABLE_OBJECT_CLOCKS
+
+//Uncomment to allow TPinInput to pass its samples through a TFilter (TPinInput::setFilter())
+//#define ENABLE_PIN_FILTERS
+
+//Uncomment to allow TPinInput and TButton to capture edges with an interrupt (TPinInput::setInterrupt())
+//#define ENABLE_PIN_INTERRUPTS
+
+//Uncomment to keep the slots of TTimer ordered by their next deadline
+//#define TTIMER_DEADLINE_ORDER
+
+//Uncomment to keep the slots of TTimer in a hierarchical timing wheel
+//#define TTIMER_TIMING_WHEEL
+
+//Uncomment to let TPin access the port registers directly (AVR only)
+//#define ENABLE_DIRECT_PORT_IO
+
+//Uncomment to use 16 bit times in the slots of TTimer and TTimeline
+//#define ENABLE_COMPACT_SLOTS
+
+//Uncomment to record lateness and callback execution time for each slot of TTimer
+//#define TTIMER_STATS
+
+#if defined(TTIMER_DEADLINE_ORDER) && defined(TTIMER_TIMING_WHEEL)
+  #error "TTIMER_DEADLINE_ORDER and TTIMER_TIMING_WHEEL cannot be used at the same time"
+#endif
+
+#if defined(ENABLE_COMPACT_SLOTS) && (defined(TTIMER_DEADLINE_ORDER) || defined(TTIMER_TIMING_WHEEL))
+  #error "ENABLE_COMPACT_SLOTS cannot be combined with TTIMER_DEADLINE_ORDER or TTIMER_TIMING_WHEEL"
+#endif
+
 #ifdef __GNUG__
 #define UNUSED_ATTR __attribute__((unused))
 #else
@@ -103,6 +138,16 @@
  * The code above will create two instances of TTimer, both able to hold 5 timers - even
  * if another value is passed to the constructor!
  * 
+ * If the instances need different numbers of slots, leave the defines commented and use
+ * the templates TTimerN and TTimelineN instead. They keep the slots inside the object
+ * and the number of slots is given for each instance (features allocated on first use,
+ * like handlers and handles, still use dynamic memory):
+ * 
+ * \code
+ * TTimerN<2> timer1(timerCallback);
+ * TTimerN<8> timer2(timerCallback);
+ * \endcode
+ * 
  * @{ @}
  * 
  * \defgroup tduino_tweaks Tweaking TDuino
@@ -158,6 +203,10 @@
  * with the missed events. If the loop phase is continuously slower than an interval then 
  * tight timing may cause issues due to 32 bit rollover.
  * 
+ * This define selects the timing used by all objects. TTimer::setTiming() and
+ * TPinOutput::setTiming() can change the timing of single timer slots and pins, which
+ * also allows a limit on the number of missed events to catch up after a stall.
+ * 
  * <div>&nbsp;</div>
  * \code
  * //#define TIMING_WITH_MICROS
@@ -190,6 +239,151 @@
  * increase accuracy by a smidgeon, you can uncomment the line above and use floating
  * point division.
  * 
+ * <div>&nbsp;</div>
+ * \code
+ * //#define ENABLE_LOOP_REGISTRY
+ * \endcode
+ * 
+ * Normally you must call loop() for each of the objects used in your sketch and each of
+ * them will read millis() (or micros()) in order to get the time, so objects looped in the
+ * same pass may see slightly different times. If you uncomment the line above, all objects
+ * will join a registry when they are constructed (and leave it when destroyed) and you
+ * can replace all the calls to loop() with a single call to TBase::loopAll(). It will read
+ * the clock once and all objects will use that same time during the pass. Each object will
+ * use an additional 2 bytes of memory (4 bytes on 32 bit boards).
+ * 
+ * \code
+ * void loop()
+ * {
+ *   TBase::loopAll(); //Loops all timers, time lines, pins and buttons
+ * }
+ * \endcode
+ * 
+ * <div>&nbsp;</div>
+ * \code
+ * //#define ENABLE_OBJECT_CLOCKS
+ * \endcode
+ * 
+ * All objects reads the time from the default clock, which is millis() (or micros()) unless
+ * another clock has been set with TBase::setDefaultClock(). If you uncomment the line above,
+ * each object can be given a clock of its own with TBase::setClock(), eg. to run a part of
+ * the sketch on a virtual clock. Each object will use an additional 2 bytes of memory (4
+ * bytes on 32 bit boards).
+ * 
+ * <div>&nbsp;</div>
+ * \code
+ * //#define ENABLE_PIN_FILTERS
+ * \endcode
+ * 
+ * If you uncomment the line above, a TFilter (eg. TFilterEMA) can be assigned to a TPinInput
+ * with TPinInput::setFilter() in order to smooth its readings. The filters themselves can be
+ * used without it, but each TPinInput will use an additional 2 bytes of memory (4 bytes on
+ * 32 bit boards) for the filter.
+ * 
+ * <div>&nbsp;</div>
+ * \code
+ * //#define ENABLE_PIN_INTERRUPTS
+ * \endcode
+ * 
+ * If you uncomment the line above, TPinInput::setInterrupt() (and TButton::setInterrupt())
+ * can be used to let an interrupt timestamp the edges on a pin. It uses attachInterrupt(),
+ * which links the interrupt handlers of the core, and the table of the inputs using an
+ * interrupt takes #TPININPUT_INTERRUPTS pointers (16 bytes on AVR) in addition to the
+ * 16 bytes of the handler table. Each TPinInput will use an additional 2 bytes of memory
+ * (4 bytes on 32 bit boards) and a buffer of #TPININPUT_EDGES edges is allocated while
+ * the interrupt is enabled. Leave it commented out if a sketch (or another library) needs
+ * the external interrupts for itself.
+ * 
+ * <div>&nbsp;</div>
+ * \code
+ * //#define TTIMER_DEADLINE_ORDER
+ * \endcode
+ * 
+ * By default TTimer::loop() will examine every active timer slot each time it is called
+ * (inactive slots are skipped using a bitmap), which is fine for a handful of active slots
+ * but it becomes expensive when many slots are active. If you uncomment the line above, TTimer will keep its active slots in a binary
+ * heap ordered by their next deadline. The heap is updated by TTimer::set(), TTimer::stop(),
+ * TTimer::restart(), TTimer::resume() and whenever a slot triggers, so TTimer::loop()
+ * only needs to examine the slot at the top of the heap and it will return immediately if
+ * that slot is not due. Each start, stop or trigger of a slot moves it up or down the heap,
+ * which takes up to log2(slots) steps (8 steps for 255 slots), and each timer slot will use
+ * two additional bytes of memory. Intervals must be below 2^31 (~24 days using millis() or
+ * ~35 minutes using micros()) for the ordering to work.
+ * 
+ * In the timer benchmark in extras/host, a trigger costs about as much as examining 15-20
+ * slots in the default mode, so the deadline order is faster when less than about 1 in 20
+ * of the active slots triggers in each loop (eg. 100 slots of which a few are due: 121 ns
+ * rather than 164 ns per loop, 1000 slots: 871 ns rather than 1525 ns) and slower when most
+ * slots trigger frequently (100 slots with intervals of 1-20 ms: 1546 ns rather than 506 ns).
+ * 
+ * <div>&nbsp;</div>
+ * \code
+ * //#define TTIMER_TIMING_WHEEL
+ * \endcode
+ * 
+ * The deadline order described above needs to move a slot in the heap whenever it is started
+ * or triggered, which becomes noticeable if many slots are triggering frequently. If you
+ * uncomment the line above, TTimer will instead place its active slots in a hierarchical
+ * timing wheel consisting of 8 levels of 16 buckets. The first level has a resolution of
+ * 1 millisecond (or microsecond) while each of the following levels is 16 times coarser,
+ * so short intervals are handled precisely and long intervals (minutes, hours or days)
+ * are moved down through the levels as their deadline gets closer. Starting, stopping and
+ * triggering a slot takes constant time regardless of the number of slots and
+ * TTimer::loop() only needs to examine the levels of the wheel when nothing is due.
+ * 
+ * The wheel uses 151 bytes of memory (167 on 32 bit boards) per instance of TTimer and 3 additional bytes per
+ * slot, so it is best suited for instances of TTimer with many slots of which only a few
+ * are due at a time. If most slots are due in every loop, the default (examining every
+ * slot) is faster than both the deadline order and the wheel, see the timer benchmark in
+ * extras/host. The wheel cannot be combined with TTIMER_DEADLINE_ORDER and intervals must
+ * be below 2^31.
+ * 
+ * <div>&nbsp;</div>
+ * \code
+ * //#define ENABLE_DIRECT_PORT_IO
+ * \endcode
+ * 
+ * Every call to digitalWrite() and digitalRead() looks up the port and bit of the pin and
+ * checks if PWM must be stopped before the pin is accessed. If you uncomment the line
+ * above, TPin will look up the port registers once in TPin::attach() and TPin::on(),
+ * TPin::off(), TPin::enable(), TPin::state() and TPin::read() will access the registers
+ * directly, TPin::flip() becomes a single write to the input register (a locked
+ * read-modify-write of the output register on older MCUs like the ATmega8, ATmega16 and
+ * ATmega32 which cannot toggle a pin that way). PWM started with
+ * TPin::pwm() is still stopped by the next digital write. Each TPin uses 5 additional
+ * bytes of memory. This tweak only has effect on AVR based boards (eg. Uno, Nano and
+ * Mega), other boards will keep using digitalWrite() and digitalRead().
+ * 
+ * <div>&nbsp;</div>
+ * \code
+ * //#define ENABLE_COMPACT_SLOTS
+ * \endcode
+ * 
+ * A TTimer slot uses 12 bytes and a TTimeline slot uses 17 bytes, which adds up quickly
+ * when a sketch needs hundreds of slots on a board with 2 KB of memory. If you uncomment
+ * the line above, the intervals, durations and starting times of the slots are stored as
+ * 16 bit values, so a TTimer slot uses 8 bytes and a TTimeline slot uses 11 bytes (plus
+ * one bit per slot for the active flag in both cases).
+ * 
+ * Intervals, durations and postponements cannot exceed 65535 (~65 seconds using millis()
+ * or ~65 milliseconds using micros()) and loop() must be called at least once within
+ * that time, otherwise a slot may be delayed until the 16 bit time wraps around. The
+ * compact slots cannot be combined with TTIMER_DEADLINE_ORDER or TTIMER_TIMING_WHEEL.
+ * 
+ * <div>&nbsp;</div>
+ * \code
+ * //#define TTIMER_STATS
+ * \endcode
+ * 
+ * When a sketch is slower than expected, it can be hard to tell which part of it is
+ * overrunning the loop phase. If you uncomment the line above, TTimer will record how
+ * many times each slot is triggered, how many periods it missed, how late it was
+ * triggered (highest and mean) and how long its callback took (highest and mean). The
+ * statistics are read with TTimer::getStats() and cleared with TTimer::resetStats().
+ * Each timer slot uses 16 additional bytes of memory (dynamic memory unless
+ * TDUINO_TIMER_SIZE is defined, also for TTimerN) and micros() is read twice for each
+ * trigger, so the define is meant for debugging and tuning.
+ * 
  * @{ @}
  * 
  * \defgroup debug_const TDuino debugging
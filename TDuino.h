@@ -20,9 +20,17 @@
 */
 
 #include "TButton.h"
+#include "TButtonBank.h"
+#include "TClock.h"
+#include "TFilter.h"
+#include "TFilterT.h"
+#include "TFilterT.cpp" //Required to avoid linkage errors
+#include "TKeyMatrix.h"
 #include "TPin.h"
+#include "TPinGroup.h"
 #include "TPinInput.h"
 #include "TPinOutput.h"
+#include "TSlotHandle.h"
 #include "TTimer.h"
 #include "TTimeline.h"
 #include "TTimelineT.h"
@@ -0,0 +1,107 @@
+/*
+  
+  Copyright © 2018 - Torben Bruchhaus
+  TDuino.bruchhaus.dk - github.com/bswebdk/TDuino
+  File: TFilter.cpp
+  
+  This program is free software: you can redistribute it and/or modify
+  it under the terms of the GNU Lesser General Public License as published
+  by the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+  
+  This program is distributed in the hope that it will be useful, but
+  WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+  Lesser General Public License for more details.
+  
+  You should have received a copy of the GNU Lesser General Public License
+  along with this program.  If not, see <http://www.gnu.org/licenses/>
+  
+*/
+
+#include "TFilter.h"
+
+#define IIR_FRACT 12 //Fractional bits of the coefficients
+#define IIR_STATE 6 //Fractional bits of the output
+
+TFilter::~TFilter()
+{
+}
+
+TFilterEMA::TFilterEMA(byte shift)
+{
+#ifdef TDUINO_DEBUG
+  if ((shift < 1) || (shift > 16)) TDuino_Error(TDUINO_ERROR_BAD_PARAMETER, shift, PSTR("TFilterEMA::TFilterEMA"));
+#endif
+  this->shift = constrain(shift, 1, 16);
+  this->acc = 0;
+}
+
+void TFilterEMA::reset(int value)
+{
+  acc = (long)value << shift;
+}
+
+int TFilterEMA::update(int sample)
+{
+  acc += sample - (acc >> shift);
+  return (acc + (1L << (shift - 1))) >> shift;
+}
+
+TFilterMedian::TFilterMedian(byte size)
+{
+#ifdef TDUINO_DEBUG
+  if ((size < 3) || (size > TFILTER_MEDIAN_MAX) || !(size & 1)) TDuino_Error(TDUINO_ERROR_BAD_PARAMETER, size, PSTR("TFilterMedian::TFilterMedian"));
+#endif
+  this->size = constrain(size | 1, 3, TFILTER_MEDIAN_MAX);
+  reset(0);
+}
+
+void TFilterMedian::reset(int value)
+{
+  for (index = 0; index < size; index++) window[index] = sorted[index] = value;
+  index = 0;
+}
+
+int TFilterMedian::update(int sample)
+{
+  byte i = 0;
+  int old = window[index];
+  window[index] = sample;
+  if (++index == size) index = 0;
+  
+  //Find the oldest sample and move the samples between it and the new sample one step
+  while (sorted[i] != old) i++;
+  if (sample > old) for (; (i < size - 1) && (sorted[i + 1] < sample); i++) sorted[i] = sorted[i + 1];
+  else for (; (i > 0) && (sorted[i - 1] > sample); i--) sorted[i] = sorted[i - 1];
+  sorted[i] = sample;
+  
+  return sorted[size >> 1];
+}
+
+TFilterIIR::TFilterIIR(float b0, float b1, float a1)
+{
+#ifdef TDUINO_DEBUG
+  if ((b0 < -1) || (b0 > 1) || (b1 < -1) || (b1 > 1) || (a1 < -1) || (a1 > 1)) TDuino_Error(TDUINO_ERROR_BAD_PARAMETER, 0, PSTR("TFilterIIR::TFilterIIR"));
+#endif
+  this->b0 = round(b0 * (1 << IIR_FRACT));
+  this->b1 = round(b1 * (1 << IIR_FRACT));
+  this->a1 = round(a1 * (1 << IIR_FRACT));
+  reset(0);
+}
+
+void TFilterIIR::reset(int value)
+{
+  //Steady state of y = b0*x + b1*x - a1*y is y = x * (b0 + b1) / (1 + a1)
+  long div = (1L << IIR_FRACT) + a1;
+  x = value;
+  y = (div != 0) ? round((float)value * (b0 + b1) * (1 << IIR_STATE) / div) : 0;
+}
+
+int TFilterIIR::update(int sample)
+{
+  long acc = (long)b0 * sample + (long)b1 * x - (((long)a1 * y) >> IIR_STATE);
+  x = sample;
+  y = acc >> (IIR_FRACT - IIR_STATE);
+  return (y + (1L << (IIR_STATE - 1))) >> IIR_STATE;
+}
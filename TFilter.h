@@ -0,0 +1,170 @@
+/*
+  
+  Copyright © 2018 - Torben Bruchhaus
+  TDuino.bruchhaus.dk - github.com/bswebdk/TDuino
+  File: TFilter.h  
+  
+  This program is free software: you can redistribute it and/or modify
+  it under the terms of the GNU Lesser General Public License as published
+  by the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+  
+  This program is distributed in the hope that it will be useful, but
+  WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+  Lesser General Public License for more details.
+  
+  You should have received a copy of the GNU Lesser General Public License
+  along with this program.  If not, see <http://www.gnu.org/licenses/>
+  
+*/
+
+#ifndef TFILTER_H
+#define TFILTER_H
+
+#include "TDefs.h"
+
+/**
+ * \brief The maximum window size of TFilterMedian.
+ */
+#define TFILTER_MEDIAN_MAX 7
+
+/**
+ * \brief Base class for filters used by TPinInput.
+ * 
+ * A filter receives one sample at a time and returns the filtered value, so the
+ * cost of each sample is constant and no sample buffer is required. A filter is
+ * assigned to an input with TPinInput::setFilter() (if ENABLE_PIN_FILTERS is defined, see
+ * \ref tduino_tweaks), or it can be fed with update() directly. The same filter can not be
+ * shared between multiple inputs since it holds the state of a single signal.
+ * 
+ * To create your own filter you should subclass TFilter and implement reset()
+ * and update():
+ * 
+ * \code
+ * class TFilterMax : public TFilter
+ * {
+ * private:
+ *   int value;
+ * public:
+ *   virtual void reset(int value) { this->value = value; }
+ *   virtual int update(int sample) { if (sample > value) value = sample; return value; }
+ * };
+ * \endcode
+ */
+class TFilter {
+
+public:
+
+  /**
+   * \brief Destructor for class TFilter.
+   * 
+   * Does nothing else than implement a virtual destructor.
+   */
+  virtual ~TFilter();
+
+  /**
+   * \brief Reset the filter.
+   * \param value The value the filter should settle on.
+   * 
+   * Reset the state of the filter as if it has been fed with _value_ forever.
+   */
+  virtual void reset(int value) = 0;
+  
+  /**
+   * \brief Feed a sample to the filter.
+   * \param sample The new sample.
+   * \return The filtered value.
+   */
+  virtual int update(int sample) = 0;
+  
+};
+
+/**
+ * \brief Exponential moving average.
+ * 
+ * Calculates <b>value += (sample - value) / 2^shift</b> using fixed point math,
+ * which smooths the signal in the same way as averaging roughly 2^(shift+1) samples
+ * but uses only 4 bytes for its state regardless of the amount of smoothing.
+ */
+class TFilterEMA : public TFilter {
+
+private:
+
+  long acc;
+  byte shift;
+  
+public:
+
+  /**
+   * \brief Constructor for class TFilterEMA.
+   * \param shift The amount of smoothing (1..16), each step halves the weight of new samples.
+   */
+  TFilterEMA(byte shift = 3);
+  
+  virtual void reset(int value);
+  virtual int update(int sample);
+
+};
+
+/**
+ * \brief Running median of the latest samples.
+ * 
+ * Returns the median of the latest _size_ samples, which removes single spikes
+ * entirely rather than smearing them out like an average would. The samples are
+ * kept sorted, so each update only moves the samples between the oldest and the
+ * newest sample.
+ */
+class TFilterMedian : public TFilter {
+
+private:
+
+  int window[TFILTER_MEDIAN_MAX], sorted[TFILTER_MEDIAN_MAX];
+  byte size, index;
+  
+public:
+
+  /**
+   * \brief Constructor for class TFilterMedian.
+   * \param size The number of samples to use (odd number, 3..#TFILTER_MEDIAN_MAX).
+   */
+  TFilterMedian(byte size = 3);
+  
+  virtual void reset(int value);
+  virtual int update(int sample);
+
+};
+
+/**
+ * \brief First order IIR filter.
+ * 
+ * Calculates <b>y = b0*x + b1*x[-1] - a1*y[-1]</b> using fixed point math with
+ * 12 fractional bits for the coefficients, which all must be in the range -1..1.
+ * 
+ * The coefficients for a low pass filter with the smoothing factor _alpha_ are
+ * b0 = alpha, b1 = 0 and a1 = alpha - 1. A high pass filter (removing a slowly
+ * drifting offset) uses b0 = c, b1 = -c and a1 = -c where c is slightly below 1.
+ */
+class TFilterIIR : public TFilter {
+
+private:
+
+  long y;
+  int b0, b1, a1, x;
+  
+public:
+
+  /**
+   * \brief Constructor for class TFilterIIR.
+   * \param b0 The coefficient for the current sample.
+   * \param b1 The coefficient for the previous sample.
+   * \param a1 The coefficient for the previous output.
+   */
+  TFilterIIR(float b0, float b1, float a1);
+  
+  virtual void reset(int value);
+  virtual int update(int sample);
+
+};
+
+#endif //TFILTER_H
@@ -0,0 +1,50 @@
+/*
+  
+  Copyright © 2018 - Torben Bruchhaus
+  TDuino.bruchhaus.dk - github.com/bswebdk/TDuino
+  File: TFilterT.cpp
+  
+  This program is free software: you can redistribute it and/or modify
+  it under the terms of the GNU Lesser General Public License as published
+  by the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+  
+  This program is distributed in the hope that it will be useful, but
+  WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+  Lesser General Public License for more details.
+  
+  You should have received a copy of the GNU Lesser General Public License
+  along with this program.  If not, see <http://www.gnu.org/licenses/>
+  
+*/
+
+#include "TFilterT.h"
+
+template <byte SIZE, class STORAGE>
+TFilterAverageT<SIZE, STORAGE>::TFilterAverageT()
+{
+#ifdef TDUINO_DEBUG
+  if (SIZE < 2) TDuino_Error(TDUINO_ERROR_BAD_PARAMETER, SIZE, PSTR("TFilterAverageT::TFilterAverageT"));
+#endif
+  reset(0);
+}
+
+template <byte SIZE, class STORAGE>
+void TFilterAverageT<SIZE, STORAGE>::reset(int value)
+{
+  for (index = 0; index < SIZE; index++) buffer.set(index, value);
+  sum = (unsigned long)buffer.get(0) * SIZE;
+  index = 0;
+}
+
+template <byte SIZE, class STORAGE>
+int TFilterAverageT<SIZE, STORAGE>::update(int sample)
+{
+  sum -= buffer.get(index);
+  buffer.set(index, sample);
+  sum += buffer.get(index); //The stored value keeps the sum in sync with the buffer
+  if (++index == SIZE) index = 0;
+  if ((SIZE & (SIZE - 1)) == 0) return sum >> TFILTER_LOG2<SIZE>::value;
+  return sum / SIZE;
+}
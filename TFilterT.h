@@ -0,0 +1,125 @@
+/*
+  
+  Copyright © 2018 - Torben Bruchhaus
+  TDuino.bruchhaus.dk - github.com/bswebdk/TDuino
+  File: TFilterT.h 
+  
+  This program is free software: you can redistribute it and/or modify
+  it under the terms of the GNU Lesser General Public License as published
+  by the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+  
+  This program is distributed in the hope that it will be useful, but
+  WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+  Lesser General Public License for more details.
+  
+  You should have received a copy of the GNU Lesser General Public License
+  along with this program.  If not, see <http://www.gnu.org/licenses/>
+  
+*/
+
+#ifndef TFILTERT_H
+#define TFILTERT_H
+
+#include "TFilter.h"
+
+/**
+ * \brief Storage type for TFilterAverageT which packs each sample into 10 bits.
+ */
+struct TFilterPacked10 {};
+
+/// \cond HIDDEN_FIELD
+template <byte N> struct TFILTER_LOG2 { enum { value = TFILTER_LOG2<N / 2>::value + 1 }; };
+template <> struct TFILTER_LOG2<1> { enum { value = 0 }; };
+
+template <byte SIZE, class STORAGE> struct TFILTER_BUFFER
+{
+  STORAGE data[SIZE];
+  unsigned int get(byte index) { return data[index]; }
+  void set(byte index, unsigned int value) { data[index] = value; }
+};
+
+template <byte SIZE> struct TFILTER_BUFFER<SIZE, TFilterPacked10>
+{
+  byte data[((unsigned int)SIZE * 10 + 7) / 8];
+  unsigned int get(byte index)
+  {
+    unsigned int bit = index * 10;
+    byte *p = data + (bit >> 3);
+    return ((p[0] | ((unsigned int)p[1] << 8)) >> (bit & 7)) & 0x3FFU; //A sample always spans two bytes
+  }
+  void set(byte index, unsigned int value)
+  {
+    unsigned int bit = index * 10, word;
+    byte *p = data + (bit >> 3);
+    //Unsigned masks, a shifted int would overflow on 16 bit boards
+    word = (p[0] | ((unsigned int)p[1] << 8)) & ~(0x3FFU << (bit & 7));
+    word |= (value & 0x3FFU) << (bit & 7);
+    p[0] = word;
+    p[1] = word >> 8;
+  }
+};
+/// \endcond
+
+/**
+ * \brief Moving average of the latest samples using a fixed size buffer.
+ * 
+ * TFilterAverageT does the same as a buffered TPinInput::setSamples() but the
+ * size of the sample buffer is given at compile time, so the buffer is part of
+ * the object and no dynamic memory is used. The samples are stored as _STORAGE_
+ * which allows the buffer to be reduced to the size needed for the pin:
+ * 
+ * \code
+ * TFilterAverageT<16, TFilterPacked10> potAverage; //10 bit analog readings
+ * TFilterAverageT<16, uint16_t> adcAverage;        //12 bit analog readings
+ * TFilterAverageT<8, byte> buttonAverage;          //Digital readings
+ * 
+ * void setup()
+ * {
+ *   pot.attach(A0);
+ *   pot.setFilter(&potAverage);
+ * }
+ * \endcode
+ * 
+ * The filter is assigned with TPinInput::setFilter() which requires ENABLE_PIN_FILTERS
+ * (see \ref tduino_tweaks), or it can be fed with update() directly.
+ * 
+ * If _SIZE_ is a power of two (2, 4, 8, 16, 32, 64 or 128) the average is calculated
+ * using a bit shift rather than a division. The samples must not be negative and must
+ * fit in _STORAGE_ (0..1023 for TFilterPacked10).
+ * 
+ * Besides the buffer the filter uses 7 bytes (a pointer to its virtual methods, the sum
+ * and the index), while setSamples() allocates 2 bytes per sample plus 2 bytes used by
+ * malloc on AVR boards. So on AVR boards int and uint16_t storage uses a few bytes more
+ * than setSamples() but keeps the samples off the heap, while byte and TFilterPacked10
+ * storage uses less (16 samples uses 23 and 27 bytes rather than 34). Packing and unpacking
+ * the 10 bit samples costs a few shifts per update(). On 32 bit boards int is 4 bytes, so
+ * uint16_t halves the buffer.
+ * 
+ * \see TFilter TPinInput::setFilter()
+ */
+template <byte SIZE, class STORAGE = int> class TFilterAverageT : public TFilter
+{
+
+private:
+
+  TFILTER_BUFFER<SIZE, STORAGE> buffer;
+  unsigned long sum;
+  byte index;
+  
+public:
+
+  /**
+   * \brief Constructor for class TFilterAverageT.
+   * 
+   * The filter is reset to zero.
+   */
+  TFilterAverageT();
+  
+  virtual void reset(int value);
+  virtual int update(int sample);
+
+};
+
+#endif //TFILTERT_H
@@ -0,0 +1,206 @@
+/*
+  
+  Copyright © 2018 - Torben Bruchhaus
+  TDuino.bruchhaus.dk - github.com/bswebdk/TDuino
+  File: TKeyMatrix.cpp
+  
+  This program is free software: you can redistribute it and/or modify
+  it under the terms of the GNU Lesser General Public License as published
+  by the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+  
+  This program is distributed in the hope that it will be useful, but
+  WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+  Lesser General Public License for more details.
+  
+  You should have received a copy of the GNU Lesser General Public License
+  along with this program.  If not, see <http://www.gnu.org/licenses/>
+  
+*/
+
+#include "TKeyMatrix.h"
+
+#define NO_KEY 255
+#define NO_ROW 255
+
+void TKeyMatrix::defaults()
+{
+  TBase::defaults();
+  this->callbacks[0] = NULL;
+  this->callbacks[1] = NULL;
+  this->lastScan = 0;
+  this->lastRepeat = 0;
+#ifdef TIMING_WITH_MICROS
+  this->debounce = 20000;
+#else
+  this->debounce = 20;
+#endif
+  this->delay1 = 0;
+  this->delay2 = 0;
+  this->numRows = 0;
+  this->row = NO_ROW;
+  this->repeatKey = NO_KEY;
+  this->firstRepeat = false;
+}
+
+TKeyMatrix::TKeyMatrix()
+{
+  defaults();
+}
+
+void TKeyMatrix::attach(const byte rowPins[], byte rowCount, const byte columnPins[], byte columnCount)
+{
+#ifdef TDUINO_DEBUG
+  if ((rowCount == 0) || (rowCount > TKEYMATRIX_MAX_LINES)) TDuino_Error(TDUINO_ERROR_BAD_PARAMETER, rowCount, PSTR("TKeyMatrix::attach"));
+  if ((columnCount == 0) || (columnCount > TKEYMATRIX_MAX_LINES)) TDuino_Error(TDUINO_ERROR_BAD_PARAMETER, columnCount, PSTR("TKeyMatrix::attach"));
+#endif
+  if (row != NO_ROW) pinMode(rows[row], INPUT);
+  if (rowCount > TKEYMATRIX_MAX_LINES) rowCount = TKEYMATRIX_MAX_LINES;
+  if (columnCount > TKEYMATRIX_MAX_LINES) columnCount = TKEYMATRIX_MAX_LINES;
+  numRows = rowCount;
+  for (byte i = 0; i < numRows; i++)
+  {
+    rows[i] = rowPins[i];
+    state[i] = 0;
+    count0[i] = 0;
+    count1[i] = 0;
+    pinMode(rows[i], INPUT);
+  }
+  columns.attach(columnPins, columnCount, INPUT_PULLUP);
+  row = NO_ROW;
+  repeatKey = NO_KEY;
+  lastScan = now();
+}
+
+byte TKeyMatrix::getSize()
+{
+  return numRows * columns.getSize();
+}
+
+bool TKeyMatrix::isPressed(byte key)
+{
+  if (key >= getSize()) //Also true if the matrix has not been attached
+  {
+  #ifdef TDUINO_DEBUG
+    TDuino_Error(TDUINO_ERROR_BAD_LIST_INDEX, key, PSTR("TKeyMatrix::isPressed"));
+  #endif
+    return false;
+  }
+  return (state[key / columns.getSize()] >> (key % columns.getSize())) & 1;
+}
+
+unsigned int TKeyMatrix::getDebounce()
+{
+  return debounce;
+}
+
+void TKeyMatrix::setDebounce(unsigned int debounce)
+{
+#ifdef TDUINO_DEBUG
+  if (debounce < 4) TDuino_Error(TDUINO_ERROR_BAD_PARAMETER, debounce, PSTR("TKeyMatrix::setDebounce"));
+#endif
+  this->debounce = (debounce < 4) ? 4 : debounce;
+}
+
+void TKeyMatrix::setRepeat(unsigned int firstDelay, unsigned int followingDelay)
+{
+  delay1 = firstDelay;
+  delay2 = followingDelay;
+}
+
+void TKeyMatrix::onPress(TPinInputCallback callback)
+{
+  callbacks[0] = callback;
+}
+
+void TKeyMatrix::onRelease(TPinInputCallback callback)
+{
+  callbacks[1] = callback;
+}
+
+void TKeyMatrix::sampleRow()
+{
+  byte numCols = columns.getSize(), sample, common, blocked = 0, delta, i;
+  sample = ~columns.read() & ((1 << numCols) - 1);
+  
+  //If the row shares two or more keys with another row, any of the shared keys could be
+  //a ghost, so new presses on those columns are blocked (keys already down are kept)
+  for (i = 0; i < numRows; i++)
+  {
+    common = sample & state[i];
+    if ((i != row) && (common & (common - 1))) blocked |= common;
+  }
+  sample &= ~blocked | state[row];
+  
+  //Vertical counter, see TButtonBank
+  delta = sample ^ state[row];
+  count1[row] = (count1[row] ^ count0[row]) & delta;
+  count0[row] = ~count0[row] & delta;
+  delta &= ~(count0[row] | count1[row]);
+  if (!delta) return;
+  state[row] ^= delta;
+  
+  for (i = 0; delta; i++, delta >>= 1)
+  {
+    if (!(delta & 1)) continue;
+    if ((state[row] >> i) & 1)
+    {
+      repeatKey = row * numCols + i;
+      firstRepeat = true;
+      lastRepeat = loopMillis;
+      if (callbacks[0]) callbacks[0](repeatKey, LOW);
+    }
+    else
+    {
+      if (repeatKey == row * numCols + i) repeatKey = NO_KEY;
+      if (callbacks[1]) callbacks[1](row * numCols + i, HIGH);
+    }
+  }
+}
+
+unsigned long TKeyMatrix::nextDueIn()
+{
+  if (row != NO_ROW) return 0;
+  unsigned long e = loopMillis - lastScan, due = debounce >> 2;
+  due = (e >= due) ? 0 : due - e;
+  if ((due > 0) && (repeatKey != NO_KEY) && (delay1 | delay2))
+  {
+    e = firstRepeat ? delay1 : delay2;
+    e = (loopMillis - lastRepeat >= e) ? 0 : e - (loopMillis - lastRepeat);
+    if (e < due) due = e;
+  }
+  return due;
+}
+
+void TKeyMatrix::loop()
+{
+  TBase::loop();
+  if (row != NO_ROW)
+  {
+    //The row was driven by the previous call, so the columns have had time to settle
+    sampleRow();
+    pinMode(rows[row], INPUT);
+    if (++row == numRows) row = NO_ROW;
+  }
+  else if (numRows && (loopMillis - lastScan >= (debounce >> 2)))
+  {
+  #ifdef ENABLE_TIGHT_TIMING
+    lastScan += debounce >> 2;
+  #else
+    lastScan = loopMillis;
+  #endif
+    row = 0;
+  }
+  if (row != NO_ROW)
+  {
+    pinMode(rows[row], OUTPUT);
+    digitalWrite(rows[row], LOW);
+  }
+  if ((repeatKey != NO_KEY) && (delay1 | delay2) && (loopMillis - lastRepeat >= (firstRepeat ? delay1 : delay2)))
+  {
+    lastRepeat = loopMillis;
+    firstRepeat = false;
+    if (callbacks[0]) callbacks[0](repeatKey, LOW);
+  }
+}
@@ -0,0 +1,181 @@
+/*
+  
+  Copyright © 2018 - Torben Bruchhaus
+  TDuino.bruchhaus.dk - github.com/bswebdk/TDuino
+  File: TKeyMatrix.h
+  
+  This program is free software: you can redistribute it and/or modify
+  it under the terms of the GNU Lesser General Public License as published
+  by the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+  
+  This program is distributed in the hope that it will be useful, but
+  WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+  Lesser General Public License for more details.
+  
+  You should have received a copy of the GNU Lesser General Public License
+  along with this program.  If not, see <http://www.gnu.org/licenses/>
+  
+*/
+
+#ifndef TKEYMATRIX_H
+#define TKEYMATRIX_H
+#include "TPinGroup.h"
+#include "TPinInput.h"
+
+/**
+ * \brief The maximum number of rows and columns in a TKeyMatrix.
+ */
+#define TKEYMATRIX_MAX_LINES 8
+
+/**
+ * \brief Scans a matrix of keys (keypad) without blocking.
+ * 
+ * The keys of a matrix are connected between a row and a column. TKeyMatrix drives one
+ * row LOW at a time (the other rows are left floating as inputs) and reads all the columns
+ * at once with a TPinGroup, so only one row is handled each time loop() is called. A full
+ * scan of the matrix is started each time a quarter of the debounce has elapsed and every
+ * key is debounced with a vertical counter, just as the buttons of TButtonBank.
+ * 
+ * The keys are numbered row by row, so the key at row _r_ and column _c_ is number
+ * <b>r * columns + c</b>. Any number of keys can be down at the same time (n-key rollover),
+ * but if the matrix has no diodes, three keys in the corners of a rectangle will make the
+ * fourth corner look pressed as well (ghosting). A key is therefore not reported as pressed
+ * while it shares two or more columns with another row, the keys which are already down
+ * are kept.
+ * 
+ * \code
+ * const byte ROW_PINS[] = { 2, 3, 4, 5 };
+ * const byte COLUMN_PINS[] = { 6, 7, 8, 9 };
+ * const char KEYS[] = "123A456B789C*0#D";
+ * TKeyMatrix keypad;
+ * 
+ * void keyPress(byte key, int state)
+ * {
+ *   Serial.println(KEYS[key]);
+ * }
+ * 
+ * void setup()
+ * {
+ *   keypad.attach(ROW_PINS, 4, COLUMN_PINS, 4);
+ *   keypad.onPress(keyPress);
+ * }
+ * \endcode
+ * 
+ * \see TButtonBank
+ */
+class TKeyMatrix : public TBase {
+
+private:
+
+  TPinGroup columns;
+  TPinInputCallback callbacks[2];
+  byte rows[TKEYMATRIX_MAX_LINES], state[TKEYMATRIX_MAX_LINES], count0[TKEYMATRIX_MAX_LINES], count1[TKEYMATRIX_MAX_LINES];
+  unsigned long lastScan, lastRepeat;
+  unsigned int debounce, delay1, delay2;
+  byte numRows, row, repeatKey;
+  bool firstRepeat;
+  
+  void sampleRow();
+
+protected:
+
+/// \cond HIDDEN_FIELD
+  virtual void defaults();
+/// \endcond
+
+public:
+
+  /**
+   * \brief Default constructor for TKeyMatrix.
+   * 
+   * You MUST call attach() before the matrix is of any use.
+   */
+  TKeyMatrix();
+  
+  /**
+   * \brief Attach the matrix to the pins of the rows and columns.
+   * \param rowPins The pins of the rows.
+   * \param rowCount The number of rows (1..#TKEYMATRIX_MAX_LINES).
+   * \param columnPins The pins of the columns.
+   * \param columnCount The number of columns (1..#TKEYMATRIX_MAX_LINES).
+   * 
+   * The rows are set to INPUT (floating) and the columns to INPUT_PULLUP. All keys
+   * are assumed to be released.
+   */
+  void attach(const byte rowPins[], byte rowCount, const byte columnPins[], byte columnCount);
+  
+  /**
+   * \brief Get the number of keys in the matrix.
+   */
+  byte getSize();
+  
+  /**
+   * \brief Detects if a key is pressed / down.
+   * \param key The number of the key.
+   * \return True if the key is pressed / down, false if the key is not in the matrix or
+   * the matrix has not been attached.
+   */
+  bool isPressed(byte key);
+  
+  /**
+   * \brief Get the amount of debounce used for the keys.
+   * \see setDebounce()
+   */
+  unsigned int getDebounce();
+  
+  /**
+   * \brief Set the amount of debounce used for the keys.
+   * \param debounce The debounce to use (4 or above).
+   * 
+   * A scan of the matrix is started each time debounce / 4 has elapsed, so a key will
+   * change state between debounce and 1.25 * debounce after it has settled (plus the time
+   * it takes to scan the matrix).
+   */
+  void setDebounce(unsigned int debounce);
+  
+  /**
+   * \brief Sets the repeat rate for the keys.
+   * \param firstDelay Delay (in milliseconds) before the first repeat.
+   * \param followingDelay Delay used for sub-sequent repeats.
+   * 
+   * Same as TButtonBank::setRepeat().
+   */
+  void setRepeat(unsigned int firstDelay, unsigned int followingDelay);
+  
+  /**
+   * \brief Set the callback used for presses.
+   * \param callback The callback to use.
+   * 
+   * The arguments passed to the callback are the number of the key and LOW.
+   */
+  void onPress(TPinInputCallback callback);
+  
+  /**
+   * \brief Set the callback used for releases.
+   * \param callback The callback to use.
+   * 
+   * The arguments passed to the callback are the number of the key and HIGH.
+   */
+  void onRelease(TPinInputCallback callback);
+  
+  /**
+   * \brief Get the time until the matrix needs to be looped again.
+   * 
+   * Zero is returned while a scan is in progress.
+   * 
+   * \see TBase::nextDueIn()
+   */
+  virtual unsigned long nextDueIn();
+  
+  /**
+   * \brief The matrix's loop method.
+   * 
+   * Reads the row which was driven by the previous call and drives the next row.
+   */
+  virtual void loop();
+
+};
+
+#endif //TKEYMATRIX_H
@@ -40,11 +40,35 @@ bool TPin::isPwmValid(int &value, const char *token)
 
 #endif //TDUINO_DEBUG
 
+#ifdef TPIN_DIRECT_IO
+
+void TPin::writeDirect(byte on)
+{
+  if ((outReg == NULL) || (mode & PWM_ACTIVE_BIT))
+  {
+    //digitalWrite() will also stop PWM on the pin
+    this->mode &= ~PWM_ACTIVE_BIT;
+    digitalWrite(pin, on);
+    return;
+  }
+  LOCK_PORT();
+  if (on == LOW) *outReg &= ~bitMask;
+  else *outReg |= bitMask;
+  UNLOCK_PORT();
+}
+
+#endif //TPIN_DIRECT_IO
+
 void TPin::defaults()
 {
   TBase::defaults();
   this->pin = 255;
   this->mode = 255;
+#ifdef TPIN_DIRECT_IO
+  this->outReg = NULL;
+  this->inReg = NULL;
+  this->bitMask = 0;
+#endif
 }
 
 TPin::TPin() : TBase()
@@ -59,6 +83,21 @@ void TPin::attach(byte pin, byte mode)
   this->mode = mode;
   if ((pin >= A0) && (pin < A0 + NUM_ANALOG_INPUTS)) this->mode |= ANALOG_BIT;
   if (digitalPinHasPWM(pin)) this->mode |= PWM_BIT;
+#ifdef TPIN_DIRECT_IO
+  byte port = digitalPinToPort(pin);
+  if (port == NOT_A_PORT)
+  {
+    this->outReg = NULL;
+    this->inReg = NULL;
+    this->bitMask = 0;
+  }
+  else
+  {
+    this->outReg = portOutputRegister(port);
+    this->inReg = portInputRegister(port);
+    this->bitMask = digitalPinToBitMask(pin);
+  }
+#endif
 }
 
 void TPin::enable(byte on)
@@ -66,7 +105,11 @@ void TPin::enable(byte on)
 #ifdef TDUINO_DEBUG
   if (!isPinValid(PSTR("TPin::enable"))) return;
 #endif //TDUINO_DEBUG
+#ifdef TPIN_DIRECT_IO
+  writeDirect(on);
+#else
   digitalWrite(pin, on);
+#endif
 }
 
 void TPin::flip()
@@ -74,7 +117,22 @@ void TPin::flip()
 #ifdef TDUINO_DEBUG
   if (!isPinValid(PSTR("TPin::flip"))) return;
 #endif //TDUINO_DEBUG
+#ifdef TPIN_DIRECT_IO
+  if (outReg && !(mode & PWM_ACTIVE_BIT))
+  {
+  #ifdef TPIN_NO_PIN_TOGGLE
+    LOCK_PORT();
+    *outReg ^= bitMask;
+    UNLOCK_PORT();
+  #else
+    *inReg = bitMask; //Writing to the input register toggles the output
+  #endif
+    return;
+  }
+  writeDirect(state() ^ 1);
+#else
   digitalWrite(pin, digitalRead(pin) ^ 1);
+#endif
 }
 
 void TPin::off()
@@ -82,7 +140,11 @@ void TPin::off()
 #ifdef TDUINO_DEBUG
   if (!isPinValid(PSTR("TPin::off"))) return;
 #endif //TDUINO_DEBUG
+#ifdef TPIN_DIRECT_IO
+  writeDirect(LOW);
+#else
   digitalWrite(pin, LOW);
+#endif
 }
 
 void TPin::on()
@@ -90,7 +152,11 @@ void TPin::on()
 #ifdef TDUINO_DEBUG
   if (!isPinValid(PSTR("TPin::on"))) return;
 #endif //TDUINO_DEBUG
+#ifdef TPIN_DIRECT_IO
+  writeDirect(HIGH);
+#else
   digitalWrite(pin, HIGH);
+#endif
 }
 
 void TPin::pwm(int value)
@@ -101,6 +167,9 @@ void TPin::pwm(int value)
   if (!hasPwm()) { TDuino_Error(TDUINO_ERROR_INVALID_OPERATION, pin, token); return; }
   if (!isPwmValid(value, token)) return;
 #endif //TDUINO_DEBUG
+#ifdef TPIN_DIRECT_IO
+  this->mode |= PWM_ACTIVE_BIT; //Writes must use digitalWrite() until PWM has been stopped
+#endif
   analogWrite(pin, value);
 }
 
@@ -109,7 +178,11 @@ int TPin::read()
 #ifdef TDUINO_DEBUG
   if (!isPinValid(PSTR("TPin::read"))) return 0;
 #endif //TDUINO_DEBUG
-  return (mode & ANALOG_BIT) ? analogRead(pin) : digitalRead(pin);
+  if (mode & ANALOG_BIT) return analogRead(pin);
+#ifdef TPIN_DIRECT_IO
+  if (inReg) return (*inReg & bitMask) ? HIGH : LOW;
+#endif
+  return digitalRead(pin);
 }
 
 byte TPin::state()
@@ -117,7 +190,10 @@ byte TPin::state()
 #ifdef TDUINO_DEBUG
   if (!isPinValid(PSTR("TPin::state"))) return 0;
 #endif //TDUINO_DEBUG
-   return digitalRead(pin);
+#ifdef TPIN_DIRECT_IO
+  if (inReg) return (*inReg & bitMask) ? HIGH : LOW;
+#endif
+  return digitalRead(pin);
 }
 
 bool TPin::isAnalog()
@@ -139,3 +215,8 @@ byte TPin::getPin()
 {
   return pin;
 }
+
+unsigned long TPin::nextDueIn()
+{
+  return TDUINO_NOT_DUE;
+}
@@ -25,6 +25,26 @@
 
 #define ANALOG_BIT 128
 #define PWM_BIT 64
+#define PWM_ACTIVE_BIT 32
+
+#if defined(ENABLE_DIRECT_PORT_IO) && (defined(__AVR__) || defined(TDUINO_HOST))
+  #define TPIN_DIRECT_IO
+  #ifdef TDUINO_HOST
+    typedef THostRegister TPinRegister; //Mocked register file, see extras/host
+    #define LOCK_PORT()
+    #define UNLOCK_PORT()
+  #else
+    typedef volatile uint8_t TPinRegister;
+    #define LOCK_PORT() byte oldSREG = SREG; cli()
+    #define UNLOCK_PORT() SREG = oldSREG
+  #endif
+  #if defined(__AVR_ATmega8__) || defined(__AVR_ATmega16__) || defined(__AVR_ATmega32__) || \
+      defined(__AVR_ATmega64__) || defined(__AVR_ATmega128__) || defined(__AVR_ATmega162__) || \
+      defined(__AVR_ATmega163__) || defined(__AVR_ATmega323__) || defined(__AVR_ATmega8515__) || \
+      defined(__AVR_ATmega8535__)
+    #define TPIN_NO_PIN_TOGGLE //Writing PINx does not toggle the output on these MCUs
+  #endif
+#endif
 
 /**
  * \brief Handles I/O for a single pin.
@@ -42,7 +62,14 @@ protected:
 #endif //TDUINO_DEBUG
 
   byte pin; ///< The pin assigned to this instance.
-  byte mode; ///< The mode used for the pin (INPUT / INPUT_PULLUP / OUTPUT). The two high order bits are used to store additional info about the pin.
+  byte mode; ///< The mode used for the pin (INPUT / INPUT_PULLUP / OUTPUT). The three high order bits are used to store additional info about the pin.
+
+#ifdef TPIN_DIRECT_IO
+  TPinRegister *outReg; ///< The output register of the pin's port (NULL if unknown).
+  TPinRegister *inReg; ///< The input register of the pin's port.
+  byte bitMask; ///< The bit of the pin in the port registers.
+  void writeDirect(byte on);
+#endif
 
 /// \cond HIDDEN_FIELD
   virtual void defaults();
@@ -73,6 +100,9 @@ public:
    * attach() will store the values provided as arguments in #pin and #mode and test
    * wheter the pin is analog and store the value in #analog. When this is done, the
    * mode of the pin will be selected with pinMode().
+   * 
+   * If ENABLE_DIRECT_PORT_IO is defined (see \ref tduino_tweaks), the port registers
+   * of the pin are looked up here, once, rather than by every digitalWrite() / digitalRead().
    */
   virtual void attach(byte pin, byte mode = INPUT);
   
@@ -187,6 +217,15 @@ public:
 	* \see TPin().
 	*/
   byte getPin();
+  
+  /**
+   * \brief Get the time until the pin needs to be looped again.
+   * 
+   * A plain TPin has nothing to do in loop(), so TDUINO_NOT_DUE is returned.
+   * 
+   * \see TBase::nextDueIn()
+   */
+  virtual unsigned long nextDueIn();
 
 };
 
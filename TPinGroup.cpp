@@ -0,0 +1,246 @@
+/*
+  
+  Copyright © 2018 - Torben Bruchhaus
+  TDuino.bruchhaus.dk - github.com/bswebdk/TDuino
+  File: TPinGroup.cpp 
+  
+  This program is free software: you can redistribute it and/or modify
+  it under the terms of the GNU Lesser General Public License as published
+  by the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+  
+  This program is distributed in the hope that it will be useful, but
+  WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+  Lesser General Public License for more details.
+  
+  You should have received a copy of the GNU Lesser General Public License
+  along with this program.  If not, see <http://www.gnu.org/licenses/>
+  
+*/
+
+#include "TPinGroup.h"
+
+#ifdef TPIN_DIRECT_IO
+//The patterns are handled as bytes, which avoids shifting a 32 bit value for each pin
+#define SPLIT(value, bytes) byte bytes[4] = { (byte)(value), (byte)((value) >> 8), (byte)((value) >> 16), (byte)((value) >> 24) }
+#define JOIN(bytes) (((unsigned long)bytes[3] << 24) | ((unsigned long)bytes[2] << 16) | ((unsigned int)bytes[1] << 8) | bytes[0])
+#endif
+
+void TPinGroup::defaults()
+{
+  TBase::defaults();
+  this->pins = NULL;
+  this->numPins = 0;
+#ifdef TPIN_DIRECT_IO
+  this->bits = NULL;
+  this->ports = NULL;
+  this->numPorts = 0;
+#endif
+}
+
+TPinGroup::TPinGroup() : TBase()
+{
+  defaults();
+}
+
+TPinGroup::~TPinGroup()
+{
+  release();
+}
+
+void TPinGroup::release()
+{
+  if (pins) delete[] pins;
+#ifdef TPIN_DIRECT_IO
+  if (bits) delete[] bits;
+  if (ports) delete[] ports;
+#endif
+  defaults();
+}
+
+void TPinGroup::attach(const byte pins[], byte count, byte mode)
+{
+#ifdef TDUINO_DEBUG
+  if ((count == 0) || (count > TPINGROUP_MAX_PINS))
+  {
+    TDuino_Error(TDUINO_ERROR_BAD_PARAMETER, count, PSTR("TPinGroup::attach"));
+    return;
+  }
+#endif
+  release();
+  this->numPins = count;
+  this->pins = new TPINGROUP_PIN[count];
+  byte i;
+  
+  for (i = 0; i < count; i++)
+  {
+    pinMode(pins[i], mode);
+    this->pins[i].pin = pins[i];
+  }
+  
+#ifdef TPIN_DIRECT_IO
+  //Count the distinct ports first, so the ports can be allocated without a temporary buffer
+  byte j, p, port;
+  for (i = 0; i < count; i++)
+  {
+    port = digitalPinToPort(pins[i]);
+    if (port == NOT_A_PORT) continue;
+    for (j = 0; (j < i) && (digitalPinToPort(pins[j]) != port); j++);
+    if (j == i) numPorts++;
+  }
+  if (numPorts > 0) this->ports = new TPINGROUP_PORT[numPorts];
+  this->bits = new TPINGROUP_BIT[count];
+  numPorts = 0;
+  for (i = 0; i < count; i++)
+  {
+    port = digitalPinToPort(pins[i]);
+    if (port == NOT_A_PORT) continue;
+    //The port registers are written directly, which does not stop PWM like digitalWrite() does
+    if ((mode == OUTPUT) && digitalPinHasPWM(pins[i])) digitalWrite(pins[i], digitalRead(pins[i]));
+    for (p = 0; (p < numPorts) && (ports[p].outReg != portOutputRegister(port)); p++);
+    if (p == numPorts)
+    {
+      ports[p].outReg = portOutputRegister(port);
+      ports[p].inReg = portInputRegister(port);
+      ports[p].count = 0;
+      numPorts++;
+    }
+    ports[p].count++;
+  }
+  
+  //Sort the bits by port (in the order of the ports) followed by the pins without a port
+  TPINGROUP_BIT *b = this->bits;
+  for (p = 0; p <= numPorts; p++)
+  {
+    for (i = 0; i < count; i++)
+    {
+      port = digitalPinToPort(pins[i]);
+      if (p < numPorts ? ((port == NOT_A_PORT) || (portOutputRegister(port) != ports[p].outReg)) : (port != NOT_A_PORT)) continue;
+      b->offset = i >> 3;
+      b->bit = 1 << (i & 7);
+      b->mask = (p < numPorts) ? digitalPinToBitMask(pins[i]) : pins[i];
+      b++;
+    }
+  }
+#endif
+}
+
+byte TPinGroup::getSize()
+{
+  return numPins;
+}
+
+byte TPinGroup::getPin(byte index)
+{
+#ifdef TDUINO_DEBUG
+  if (index >= numPins)
+  {
+    TDuino_Error(TDUINO_ERROR_BAD_LIST_INDEX, index, PSTR("TPinGroup::getPin"));
+    return 255;
+  }
+#endif
+  return pins[index].pin;
+}
+
+void TPinGroup::write(unsigned long pattern)
+{
+  write(pattern, 0xFFFFFFFFUL);
+}
+
+void TPinGroup::write(unsigned long pattern, unsigned long mask)
+{
+#ifdef TPIN_DIRECT_IO
+  SPLIT(pattern, values);
+  SPLIT(mask, used);
+  TPINGROUP_BIT *b = bits, *end = bits + numPins;
+  byte p, n, setBits, clearBits;
+  for (p = 0; p < numPorts; p++)
+  {
+    setBits = 0;
+    clearBits = 0;
+    for (n = ports[p].count; n > 0; n--, b++)
+    {
+      if (!(used[b->offset] & b->bit)) continue;
+      if (values[b->offset] & b->bit) setBits |= b->mask;
+      else clearBits |= b->mask;
+    }
+    if ((setBits | clearBits) == 0) continue;
+    LOCK_PORT();
+    *ports[p].outReg = (*ports[p].outReg & ~clearBits) | setBits;
+    UNLOCK_PORT();
+  }
+  for (; b < end; b++)
+    if (used[b->offset] & b->bit) digitalWrite(b->mask, (values[b->offset] & b->bit) ? HIGH : LOW);
+#else
+  unsigned long bit;
+  byte i;
+  for (i = 0, bit = 1; i < numPins; i++, bit <<= 1)
+    if (mask & bit) digitalWrite(pins[i].pin, (pattern & bit) ? HIGH : LOW);
+#endif
+}
+
+unsigned long TPinGroup::read()
+{
+#ifdef TPIN_DIRECT_IO
+  byte values[4] = { 0, 0, 0, 0 }, p, n, state;
+  TPINGROUP_BIT *b = bits, *end = bits + numPins;
+  for (p = 0; p < numPorts; p++)
+  {
+    state = *ports[p].inReg;
+    for (n = ports[p].count; n > 0; n--, b++)
+      if (state & b->mask) values[b->offset] |= b->bit;
+  }
+  for (; b < end; b++)
+    if (digitalRead(b->mask)) values[b->offset] |= b->bit;
+  return JOIN(values);
+#else
+  unsigned long bit, pattern = 0;
+  byte i;
+  for (i = 0, bit = 1; i < numPins; i++, bit <<= 1)
+    if (digitalRead(pins[i].pin)) pattern |= bit;
+  return pattern;
+#endif
+}
+
+void TPinGroup::flip(unsigned long mask)
+{
+#ifdef TPIN_DIRECT_IO
+  SPLIT(mask, used);
+  TPINGROUP_BIT *b = bits, *end = bits + numPins;
+  byte p, n, flipBits;
+  for (p = 0; p < numPorts; p++)
+  {
+    flipBits = 0;
+    for (n = ports[p].count; n > 0; n--, b++)
+      if (used[b->offset] & b->bit) flipBits |= b->mask;
+    if (flipBits == 0) continue;
+  #ifdef TPIN_NO_PIN_TOGGLE
+    LOCK_PORT();
+    *ports[p].outReg ^= flipBits;
+    UNLOCK_PORT();
+  #else
+    *ports[p].inReg = flipBits; //Writing to the input register toggles the output
+  #endif
+  }
+  for (; b < end; b++)
+    if (used[b->offset] & b->bit) digitalWrite(b->mask, digitalRead(b->mask) ^ 1);
+#else
+  write(~read(), mask);
+#endif
+}
+
+void TPinGroup::on()
+{
+  write(0xFFFFFFFFUL);
+}
+
+void TPinGroup::off()
+{
+  write(0);
+}
+
+unsigned long TPinGroup::nextDueIn()
+{
+  return TDUINO_NOT_DUE;
+}
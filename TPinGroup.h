@@ -0,0 +1,188 @@
+/*
+  
+  Copyright © 2018 - Torben Bruchhaus
+  TDuino.bruchhaus.dk - github.com/bswebdk/TDuino
+  File: TPinGroup.h    
+  
+  This program is free software: you can redistribute it and/or modify
+  it under the terms of the GNU Lesser General Public License as published
+  by the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+  
+  This program is distributed in the hope that it will be useful, but
+  WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+  Lesser General Public License for more details.
+  
+  You should have received a copy of the GNU Lesser General Public License
+  along with this program.  If not, see <http://www.gnu.org/licenses/>
+  
+*/
+
+#ifndef TPINGROUP_H
+#define TPINGROUP_H
+#include "TPin.h"
+
+/**
+ * \brief The maximum number of pins in a TPinGroup.
+ */
+#define TPINGROUP_MAX_PINS 32
+
+/// \cond HIDDEN_FIELD
+
+struct TPINGROUP_PIN
+{
+  byte pin;
+};
+
+#ifdef TPIN_DIRECT_IO
+//A pin of the group as a byte and bit of the group pattern and its bit on the port. The
+//bits are sorted by port, pins without a port are last and keep their pin number in "mask".
+struct TPINGROUP_BIT
+{
+  byte offset, bit, mask;
+};
+
+struct TPINGROUP_PORT
+{
+  TPinRegister *outReg, *inReg;
+  byte count; //Number of bits on the port
+};
+#endif
+
+/// \endcond
+
+/**
+ * \brief Handles I/O for a group of digital pins.
+ * 
+ * TPinGroup reads and writes up to 32 digital pins at once using a bit pattern where
+ * bit 0 is the first pin in the group, bit 1 the second pin and so on.
+ * 
+ * \code
+ * const byte LED_PINS[] = { 2, 3, 4, 5, 6, 7, 8, 9 };
+ * TPinGroup leds;
+ * 
+ * void setup()
+ * {
+ *   leds.attach(LED_PINS, 8);
+ *   leds.write(0b10101010); //Every second LED on
+ * }
+ * \endcode
+ * 
+ * If ENABLE_DIRECT_PORT_IO is defined (see \ref tduino_tweaks), the pins are grouped by
+ * their hardware port in attach() and write() and read() will only access each port once,
+ * regardless of the number of pins on the port. Otherwise digitalWrite() and digitalRead()
+ * is used for each pin. Since the ports are written directly, PWM is not stopped by write()
+ * like it is by digitalWrite(). PWM is stopped on the pins of the group in attach(), so if
+ * PWM is started on a pin of the group afterwards (eg. with analogWrite()), it must be
+ * stopped with digitalWrite() before the group is used.
+ */
+class TPinGroup : public TBase {
+
+private:
+
+  TPINGROUP_PIN *pins;
+  byte numPins;
+#ifdef TPIN_DIRECT_IO
+  TPINGROUP_BIT *bits;
+  TPINGROUP_PORT *ports;
+  byte numPorts;
+#endif
+  
+  void release();
+
+protected:
+
+/// \cond HIDDEN_FIELD
+  virtual void defaults();
+/// \endcond
+
+public:
+
+  /**
+   * \brief Default constructor for TPinGroup.
+   * 
+   * You MUST call attach() before the group is of any use.
+   */
+  TPinGroup();
+  
+  /**
+   * \brief Destructor for TPinGroup.
+   * 
+   * Releases the memory used for the pins.
+   */
+  virtual ~TPinGroup();
+  
+  /**
+   * \brief Attach the group to a set of pins.
+   * \param pins The pins of the group.
+   * \param count The number of pins (1..32).
+   * \param mode The mode to be used for all the pins.
+   * 
+   * The mode of all the pins will be selected with pinMode(). Memory usage (in bytes)
+   * is 4 * count, or count if ENABLE_DIRECT_PORT_IO is not defined, plus 5 per port
+   * (9 on 32 bit boards) when ENABLE_DIRECT_PORT_IO is defined. With ENABLE_DIRECT_PORT_IO
+   * the pins are sorted by port in attach(), so write(), read() and flip() visits each
+   * pin once and accesses each port once.
+   */
+  void attach(const byte pins[], byte count, byte mode = OUTPUT);
+  
+  /**
+   * \brief Get the number of pins in the group.
+   */
+  byte getSize();
+  
+  /**
+   * \brief Get a pin of the group.
+   * \param index The index of the pin in the group.
+   * \return The pin number.
+   */
+  byte getPin(byte index);
+  
+  /**
+   * \brief Set the state of all pins in the group.
+   * \param pattern The states, bit 0 is the first pin.
+   */
+  void write(unsigned long pattern);
+  
+  /**
+   * \brief Set the state of some of the pins in the group.
+   * \param pattern The states, bit 0 is the first pin.
+   * \param mask The pins to set, the state of pins whose bit is zero is not changed.
+   */
+  void write(unsigned long pattern, unsigned long mask);
+  
+  /**
+   * \brief Read the state of all pins in the group.
+   * \return The states, bit 0 is the first pin.
+   */
+  unsigned long read();
+  
+  /**
+   * \brief Flip the state of the pins in the group.
+   * \param mask The pins to flip, default is all of them.
+   */
+  void flip(unsigned long mask = 0xFFFFFFFFUL);
+  
+  /**
+   * \brief Turn on all pins in the group.
+   */
+  void on();
+  
+  /**
+   * \brief Turn off all pins in the group.
+   */
+  void off();
+  
+  /**
+   * \brief Get the time until the group needs to be looped again.
+   * 
+   * A TPinGroup has nothing to do in loop(), so TDUINO_NOT_DUE is returned.
+   * 
+   * \see TBase::nextDueIn()
+   */
+  virtual unsigned long nextDueIn();
+
+};
+
+#endif //TPINGROUP_H
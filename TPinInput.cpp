@@ -32,14 +32,38 @@
 //Used as a dummy to prevent one or two "if (callback)" statement(s) for each loop.
 void dummy_callback(byte b UNUSED_ATTR, int i UNUSED_ATTR) {}
 
+#ifdef ENABLE_PIN_INTERRUPTS
+//attachInterrupt() does not pass any arguments to the handler, so each interrupt slot
+//has its own handler which knows which TPinInput to notify.
+TPinInput *TPinInput::irqInputs[TPININPUT_INTERRUPTS] = { NULL };
+
+template <byte N> void TPinInput::irqHandler()
+{
+  if (irqInputs[N]) irqInputs[N]->captureEdge();
+}
+
+void (*const TPinInput::irqHandlers[TPININPUT_INTERRUPTS])() = {
+  TPinInput::irqHandler<0>, TPinInput::irqHandler<1>, TPinInput::irqHandler<2>, TPinInput::irqHandler<3>,
+  TPinInput::irqHandler<4>, TPinInput::irqHandler<5>, TPinInput::irqHandler<6>, TPinInput::irqHandler<7>
+};
+#endif
+
 void TPinInput::defaults()
 {
   TPin::defaults();
   this->sampleIdx = 0;
   this->sampleVal = 0;
   this->deviation = 1;
+  this->fixedDeviation = false;
   this->samples = 0;
   this->sampleBuffer = NULL;
+#ifdef ENABLE_PIN_FILTERS
+  this->filter = NULL;
+#endif
+  this->async = NULL;
+#ifdef ENABLE_PIN_INTERRUPTS
+  this->irq = NULL;
+#endif
   this->lastState = 0;
   this->debounce = 0;
   this->changeMillis = 0;
@@ -64,7 +88,11 @@ TPinInput::TPinInput()
 
 TPinInput::~TPinInput()
 {
+#ifdef ENABLE_PIN_INTERRUPTS
+  setInterrupt(false);
+#endif
   if (sampleBuffer) delete[] sampleBuffer;
+  if (async) delete async;
 }
 
 void TPinInput::attach(byte pin, byte mode)
@@ -101,16 +129,58 @@ int TPinInput::read(byte samples)
   if (debounce > 0)
   {
     if (mode & ANALOG_BIT) for (dummy = 0; dummy < samples; dummy++) { delay(debounce); res += analogRead(pin); }
-    else for (dummy = 0; dummy < samples; dummy++) { delay(debounce); res += digitalRead(pin); }
+    else for (dummy = 0; dummy < samples; dummy++) { delay(debounce); res += state(); }
   }
   else
   {
     if (mode & ANALOG_BIT) for (dummy = 0; dummy < samples; dummy++) res += analogRead(pin);
-    else for (dummy = 0; dummy < samples; dummy++) res += digitalRead(pin);
+    else for (dummy = 0; dummy < samples; dummy++) res += state();
   }
   return SAMPLEDIV(res, samples); //round(res / samples);
 }
 
+bool TPinInput::readAsync(byte samples, TPinInputCallback callback)
+{
+#ifdef TDUINO_DEBUG
+  if (samples < 2)
+  {
+     TDuino_Error(TDUINO_ERROR_BAD_PARAMETER, samples, PSTR("TPinInput::readAsync"));
+     return false;
+  }
+#else
+  if (samples < 2) return false;
+#endif //TDUINO_DEBUG
+  if (async == NULL) async = new TPININPUT_ASYNC;
+  async->callback = callback;
+  async->sum = 0;
+  async->lastMillis = loopMillis;
+  async->result = -1;
+  async->samples = samples;
+  async->count = 0;
+  return true;
+}
+
+bool TPinInput::readReady()
+{
+  return async && (async->result >= 0);
+}
+
+int TPinInput::getReadResult()
+{
+  return async ? async->result : -1;
+}
+
+void TPinInput::asyncLoop()
+{
+  if (loopMillis - async->lastMillis < debounce) return;
+  async->lastMillis = loopMillis;
+  async->sum += (mode & ANALOG_BIT) ? analogRead(pin) : state();
+  if (++async->count < async->samples) return;
+  async->result = SAMPLEDIV(async->sum, async->samples);
+  async->samples = 0;
+  if (async->callback) async->callback(pin, async->result);
+}
+
 unsigned int TPinInput::getDebounce()
 {
   return debounce;
@@ -178,19 +248,149 @@ void TPinInput::setSamples(byte samples, bool buffered)
   }
 }
 
+#ifdef ENABLE_PIN_FILTERS
+TFilter *TPinInput::getFilter()
+{
+  return filter;
+}
+
+void TPinInput::setFilter(TFilter *filter)
+{
+  this->filter = filter;
+  if (filter) filter->reset(read());
+}
+#endif
+
+#ifdef ENABLE_PIN_INTERRUPTS
+bool TPinInput::setInterrupt(bool enable)
+{
+  if (irq)
+  {
+    if (enable) return true;
+    detachInterrupt(digitalPinToInterrupt(pin));
+    irqInputs[irq->slot] = NULL;
+    delete irq;
+    irq = NULL;
+    return false;
+  }
+  if (!enable) return false;
+  
+  byte slot = 0;
+  int irqNum = digitalPinToInterrupt(pin);
+  while ((slot < TPININPUT_INTERRUPTS) && irqInputs[slot]) slot++;
+  if ((irqNum < 0) || isAnalog() || (slot == TPININPUT_INTERRUPTS))
+  {
+  #ifdef TDUINO_DEBUG
+    TDuino_Error(TDUINO_ERROR_INVALID_OPERATION, pin, PSTR("TPinInput::setInterrupt"));
+  #endif
+    return false;
+  }
+  
+  irq = new TPININPUT_IRQ;
+  irq->head = 0;
+  irq->tail = 0;
+  irq->level = state();
+  irq->slot = slot;
+  irqInputs[slot] = this;
+  attachInterrupt(irqNum, irqHandlers[slot], CHANGE);
+  return true;
+}
+
+void TPinInput::captureEdge()
+{
+  byte level = state(), next;
+  irq->level = level;
+  next = (irq->head + 1) & (TPININPUT_EDGES - 1);
+  if (next == irq->tail) return; //Full, loop() will still see the final level
+  irq->edges[irq->head].time = TClock::hardware(); //now() may read a clock which is not interrupt safe
+  irq->edges[irq->head].level = level;
+  irq->head = next; //Publish the edge after it has been written
+}
+
+void TPinInput::interruptLoop()
+{
+  volatile TPININPUT_EDGE *edge;
+  unsigned long hw = TClock::hardware(), age, at;
+  while (irq->tail != irq->head)
+  {
+    edge = &irq->edges[irq->tail];
+    //Map the hardware timestamp to the clock of this object by its age
+    age = hw - edge->time;
+    if ((long)age < 0) age = 0; //Captured after the hardware clock was read
+    at = loopMillis - age;
+    if ((long)(at - changeMillis) < 0) at = changeMillis; //The clock of this object runs slower
+    if ((edge->level != lastState) && (at - changeMillis >= debounce)) changeTo(edge->level, at);
+    irq->tail = (irq->tail + 1) & (TPININPUT_EDGES - 1);
+  }
+  //The last edge may have been rejected by debounce or dropped, make sure that the final level is used
+  if ((irq->level != lastState) && (loopMillis - changeMillis >= debounce)) changeTo(irq->level, loopMillis);
+}
+#endif
+
+bool TPinInput::changeTo(int value, unsigned long at)
+{
+  if (value >= (lastState + deviation))
+  {
+    changeMillis = at;
+    lastState = (fixedDeviation && (deviation > 0)) ? lastState + deviation : value;
+    rising();
+  }
+  else if (value <= (lastState - deviation))
+  {
+    changeMillis = at;
+    lastState = (fixedDeviation && (deviation > 0)) ? lastState - deviation : value;
+    falling();
+  }
+  else return false;
+  return true;
+}
+
+unsigned long TPinInput::nextDueIn()
+{
+  unsigned long e = loopMillis - changeMillis;
+#ifdef ENABLE_PIN_INTERRUPTS
+  if (irq && (irq->tail == irq->head) && (irq->level == lastState) && !(async && (async->samples > 0)))
+    return TDUINO_NOT_DUE; //The interrupt will capture the next edge
+#endif
+  if ((e < debounce) && async && (async->samples > 0) && (loopMillis - async->lastMillis > e))
+    e = loopMillis - async->lastMillis; //Next sample is due before the debounce of events
+  return (e >= debounce) ? 0 : debounce - e;
+}
+
 void TPinInput::loop()
 {
   
   TPin::loop();
   
+  if (async && (async->samples > 0)) asyncLoop();
+  
+#ifdef ENABLE_PIN_INTERRUPTS
+  if (irq)
+  {
+    interruptLoop();
+    return;
+  }
+#endif
+  
   #ifdef ENABLE_TIGHT_TIMING
   #define CHMS() changeMillis += debounce
+  //An event after an idle period restarts the debounce from now rather than from the past
+  #define CHMS_NEXT() ((loopMillis - changeMillis < (unsigned long)debounce << 1) ? changeMillis + debounce : loopMillis)
   #else
   #define CHMS() changeMillis = loopMillis
+  #define CHMS_NEXT() loopMillis
   #endif
 
   if (loopMillis - changeMillis >= debounce) {
 
+  #ifdef ENABLE_PIN_FILTERS
+    if (filter)
+    {
+      CHMS();
+      dummy = filter->update(read());
+    }
+    else
+  #endif
     if (sampleBuffer)
     {
       CHMS();
@@ -219,19 +419,7 @@ void TPinInput::loop()
       }
     }
     
-    if (dummy >= (lastState + deviation))
-    {
-      lastState = (fixedDeviation && (deviation > 0)) ? lastState + deviation : dummy;
-      rising();
-    }
-    else if (dummy <= (lastState - deviation))
-    {
-      lastState = (fixedDeviation && (deviation > 0)) ? lastState - deviation : dummy;
-      falling();
-    }
-    else return;
-    
-    CHMS();
+    changeTo(dummy, CHMS_NEXT());
     
   }
 
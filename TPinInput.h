@@ -22,12 +22,52 @@
 #ifndef TPININPUT_H
 #define TPININPUT_H
 #include "TPin.h"
+#include "TFilter.h"
 
 /**
  * \brief The callback type used for input pins
  */
 typedef void (*TPinInputCallback)(byte, int);
 
+#ifdef ENABLE_PIN_INTERRUPTS
+/**
+ * \brief The maximum number of TPinInput's which can use interrupts at the same time.
+ */
+#define TPININPUT_INTERRUPTS 8
+
+/**
+ * \brief The number of edges which can be captured between two calls to loop() (power of two).
+ */
+#define TPININPUT_EDGES 8
+#endif
+
+/// \cond HIDDEN_FIELD
+
+#ifdef ENABLE_PIN_INTERRUPTS
+struct TPININPUT_EDGE
+{
+  unsigned long time;
+  byte level;
+};
+
+struct TPININPUT_IRQ
+{
+  volatile TPININPUT_EDGE edges[TPININPUT_EDGES];
+  volatile byte head, tail, level;
+  byte slot;
+};
+#endif
+
+struct TPININPUT_ASYNC
+{
+  TPinInputCallback callback;
+  unsigned long sum, lastMillis;
+  int result;
+  byte samples, count;
+};
+
+/// \endcond
+
 /**
  * \brief Attach events to handle input from a pin.
  * 
@@ -41,6 +81,20 @@ private:
   byte sampleIdx;
   unsigned int sampleVal;
   int dummy;
+  TPININPUT_ASYNC *async;
+#ifdef ENABLE_PIN_INTERRUPTS
+  TPININPUT_IRQ *irq;
+  
+  static TPinInput *irqInputs[TPININPUT_INTERRUPTS];
+  static void (*const irqHandlers[TPININPUT_INTERRUPTS])();
+  template <byte N> static void irqHandler();
+  
+  void captureEdge();
+  void interruptLoop();
+#endif
+  
+  void asyncLoop();
+  bool changeTo(int value, unsigned long at);
   
 protected:
 
@@ -49,6 +103,9 @@ protected:
   bool fixedDeviation; ///< If deviation is to be handled as fixed steps
   byte samples; ///< The number of samples to use for events
   int* sampleBuffer; ///< Buffer used for storing multiple samples
+#ifdef ENABLE_PIN_FILTERS
+  TFilter *filter; ///< Filter used for samples (if any)
+#endif
   int lastState; ///< The last known state of the pin. See loop().
   unsigned int debounce; ///< The amount of debounce used with the pin.
   unsigned long changeMillis; ///< The time of the last state change
@@ -107,18 +164,73 @@ public:
   
   /**
    * \brief Get the average value of multiple readings from the pin.
-   * \param samples The number of samples to get (MUST be above 2).
+   * \param samples The number of samples to get (MUST be 2 or more).
    * \returns The average value of the pin.
    * 
    * This will return the average value of _samples_ readings from the pin with
    * analogRead for analog pins and digitalRead for digital pins. If any debounce
    * has been specified, the debounce will cause a (blocking!) delay of _debounce_
-   * length before each read.
+   * length before each read. Use readAsync() if you do not want to block the sketch.
    * 
-   * \see setDebounce()
+   * \see setDebounce() readAsync()
    */
   int read(byte samples);
   
+  /**
+   * \brief Start reading the average value of multiple readings from the pin.
+   * \param samples The number of samples to get (MUST be 2 or more).
+   * \param callback Callback which receives the pin and the average value (optional).
+   * \returns True if the reading was started.
+   * 
+   * Same as read(byte) except that the samples are taken by loop(), one sample each time
+   * _debounce_ has elapsed, so nothing is blocked while sampling. When all samples have
+   * been taken, the average is passed to _callback_ and it is available from getReadResult().
+   * Starting a new reading will abort any reading in progress.
+   * 
+   * \code
+   * void setup()
+   * {
+   *   input.attach(A0);
+   *   input.setDebounce(10);
+   *   input.readAsync(10); //Takes 100 milliseconds without blocking
+   * }
+   * 
+   * void loop()
+   * {
+   *   input.loop();
+   *   if (input.readReady())
+   *   {
+   *     Serial.println(input.getReadResult());
+   *     input.readAsync(10); //Start the next reading, which also clears readReady()
+   *   }
+   * }
+   * \endcode
+   * 
+   * The first call uses 14 bytes of dynamic memory (20 bytes on 32 bit boards) which
+   * is reused by the following readings.
+   * 
+   * \see readReady() getReadResult() setDebounce()
+   */
+  bool readAsync(byte samples, TPinInputCallback callback = NULL);
+  
+  /**
+   * \brief Check if a reading started with readAsync() has completed.
+   * \returns True if the result is ready.
+   * 
+   * The result stays ready until the next reading is started with readAsync().
+   * 
+   * \see readAsync() getReadResult()
+   */
+  bool readReady();
+  
+  /**
+   * \brief Get the result of a reading started with readAsync().
+   * \returns The average value or -1 if the reading has not completed.
+   * 
+   * \see readAsync() readReady()
+   */
+  int getReadResult();
+  
   using TPin::read; //Required for overload
 
   /**
@@ -214,7 +326,7 @@ public:
   * is triggered, the value passed to it will be calculated from _samples_ new readings.
   * 
   * If _buffered_ is true, _samples_ readings from the pin will be stored in a buffer
-  * (BEWARE: dynamic memory usage!) in order to calculate an average reading for the
+  * (BEWARE: dynamic memory usage! See TFilterAverageT for an alternative) in order to calculate an average reading for the
   * event. This means that the value passed to the event is an average of one new
   * reading combined with _samples_-1 old readings.
   * 
@@ -226,6 +338,86 @@ public:
   * \see read(byte) onRising() onFalling() setDebounce()
   */
   void setSamples(byte samples, bool buffered = false);
+  
+#ifdef ENABLE_PIN_FILTERS
+  /**
+   * \brief Get the filter used with events.
+   * 
+   * \see setFilter()
+   */
+  TFilter *getFilter();
+  
+  /**
+   * \brief Set the filter used with events.
+   * \param filter The filter to use or NULL to stop filtering.
+   * 
+   * Only available if ENABLE_PIN_FILTERS is defined (see \ref tduino_tweaks).
+   * 
+   * When a filter is used, a single sample is read each time _debounce_ has elapsed and
+   * it is passed through the filter. The filtered value is then used to trigger events
+   * (minding deviation). The filter replaces sampling (setSamples()), so no sample buffer
+   * is required in order to get smooth readings from an analog pin:
+   * 
+   * \code
+   * TFilterEMA potFilter(4);
+   * 
+   * void setup()
+   * {
+   *   pot.attach(A0);
+   *   pot.setDebounce(5);
+   *   pot.setDeviation(2);
+   *   pot.setFilter(&potFilter);
+   * }
+   * \endcode
+   * 
+   * The filter is reset with a reading from the pin. The filter is not owned by the
+   * TPinInput, so it must stay alive while it is in use and a filter can not be shared
+   * between multiple inputs.
+   * 
+   * \see TFilter TFilterEMA TFilterMedian TFilterIIR setSamples()
+   */
+  void setFilter(TFilter *filter);
+#endif
+  
+#ifdef ENABLE_PIN_INTERRUPTS
+  /**
+   * \brief Enable / disable interrupt driven edge capture.
+   * \param enable True to use an interrupt.
+   * \returns True if the interrupt is used.
+   * 
+   * By default loop() reads the pin every time it is called, so a change of the pin
+   * state is only detected when loop() is called. If an interrupt is used, every edge
+   * on the pin is timestamped by the interrupt and stored in a small buffer. When loop()
+   * is called the edges in the buffer are handled using the timestamps for debounce
+   * and the pin itself is not read at all. Up to #TPININPUT_EDGES edges can be captured
+   * between two calls to loop(), any further edges are dropped but the final state of
+   * the pin is never lost.
+   * 
+   * The interrupt timestamps the edges with TClock::hardware() and loop() maps the
+   * timestamps to the clock used by the TPinInput (see setClock() and setDefaultClock()),
+   * so a custom clock is never read from the interrupt.
+   * 
+   * Interrupts can only be used with digital pins which supports interrupts (see
+   * digitalPinToInterrupt()) and sampling (setSamples()) is not used while the interrupt
+   * is enabled. Up to #TPININPUT_INTERRUPTS pins can use interrupts at the same time.
+   * The edge buffer is allocated when the interrupt is enabled and released when it is disabled.
+   * 
+   * \note Only available if ENABLE_PIN_INTERRUPTS is defined.
+   * 
+   * \see setDebounce() setDeviation()
+   */
+  bool setInterrupt(bool enable);
+#endif
+
+  /**
+   * \brief Get the time until the pin needs to be looped again.
+   * 
+   * The pin must be polled, so zero is returned unless the pin is waiting for
+   * the debounce to elapse (before the next event or the next sample of readAsync()).
+   * 
+   * \see TBase::nextDueIn()
+   */
+  virtual unsigned long nextDueIn();
 
   /**
 	* \brief The pin's loop method.
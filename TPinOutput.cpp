@@ -7,6 +7,9 @@ void TPinOutput::defaults()
 {
   TPin::defaults();
   this->task = 0;
+  this->timing = TDUINO_TIMING_DEFAULT;
+  this->cap = 0;
+  this->skipped = 0;
 }
 
 TPinOutput::TPinOutput()
@@ -21,11 +24,27 @@ void TPinOutput::attach(byte pin, byte mode UNUSED_ATTR)
 
 void TPinOutput::counter()
 {
-#ifdef ENABLE_TIGHT_TIMING
-  lastMillis += use_ms;
-#else
-  lastMillis = loopMillis;
-#endif
+  unsigned long late = loopMillis - lastMillis - use_ms, period = (unsigned long)msLow + msHigh, n;
+  if (timing == TDUINO_TIMING_BEST_EFFORT)
+  {
+    lastMillis = loopMillis;
+    if ((period > 0) && (late >= period)) skipped += late / period;
+  }
+  else
+  {
+    lastMillis += use_ms;
+    if ((timing == TDUINO_TIMING_CAPPED) && (period > 0) && (late >= period))
+    {
+      //Skip whole cycles beyond the cap so the pin stays in phase
+      n = late / period;
+      if (n > cap)
+      {
+        n -= cap;
+        lastMillis += n * period;
+        skipped += n;
+      }
+    }
+  }
   if ((stateCur == stateInit) && (repeats > 0) && (++count >= repeats)) stop();
 }
   
@@ -42,6 +61,7 @@ void TPinOutput::oscillate(unsigned int intervalRising, unsigned int intervalFal
   this->stateCur = this->stateInit;
   this->repeats = repetitions;
   this->count = 0;
+  this->skipped = 0;
   this->stateLow = stateLowest;
   this->stateHigh = stateHighest;
   this->stop();
@@ -66,6 +86,7 @@ void TPinOutput::pulse(unsigned int intervalLow, unsigned int intervalHigh, unsi
   this->stateInit = this->stateCur;
   this->repeats = repetitions;
   this->count = 0;
+  this->skipped = 0;
   this->stop();
   this->task = PINTASK_PULSE;
   enable(this->stateInit);
@@ -75,6 +96,32 @@ void TPinOutput::pulse(unsigned int interval, unsigned int repetitions, int init
 void TPinOutput::pulse(unsigned int interval, unsigned int repetitions) { pulse(interval, interval, repetitions, HIGH); }
 void TPinOutput::pulse(unsigned int interval) { pulse(interval, interval, 0, HIGH); }
 
+void TPinOutput::setTiming(byte policy, byte cap)
+{
+#ifdef TDUINO_DEBUG
+  if (policy > TDUINO_TIMING_CAPPED)
+  {
+    TDuino_Error(TDUINO_ERROR_BAD_PARAMETER, policy, PSTR("setTiming"));
+    return;
+  }
+#endif
+  this->timing = policy;
+  this->cap = cap;
+}
+
+unsigned int TPinOutput::getSkipped()
+{
+  return skipped;
+}
+
+unsigned long TPinOutput::nextDueIn()
+{
+  if (task == PINTASK_OSCILLATE) return 0;
+  if (task != PINTASK_PULSE) return TDUINO_NOT_DUE;
+  unsigned long e = loopMillis - lastMillis, ms = (stateCur == HIGH) ? msHigh : msLow;
+  return (e >= ms) ? 0 : ms - e;
+}
+
 void TPinOutput::loop()
 {
 
@@ -34,9 +34,9 @@ class TPinOutput : public TPin {
 private:
 
   int stateCur, stateInit, stateLow, stateHigh;
-  byte task;
+  byte task, timing, cap;
   unsigned long lastMillis;
-  unsigned int msLow, msHigh, repeats, count, use_ms;
+  unsigned int msLow, msHigh, repeats, count, use_ms, skipped;
 
   void counter();
 
@@ -175,6 +175,37 @@ public:
 	*/
   void pulse(unsigned int interval);
   
+  /**
+   * \brief Set the timing policy of pulse() and oscillate().
+   * \param policy #TDUINO_TIMING_BEST_EFFORT, #TDUINO_TIMING_TIGHT or #TDUINO_TIMING_CAPPED.
+   * \param cap The number of missed cycles to catch up when using #TDUINO_TIMING_CAPPED.
+   * 
+   * By default the timing selected with ENABLE_TIGHT_TIMING is used (see \ref tduino_tweaks).
+   * The policies are described in TTimer::setTiming(), for TPinOutput a period is a full
+   * cycle (low and high, or rising and falling). The policy is kept when a new pulse or
+   * oscillation is started.
+   * 
+   * \see getSkipped()
+   */
+  void setTiming(byte policy, byte cap = 0);
+  
+  /**
+   * \brief Get the number of cycles skipped by the current pulse or oscillation.
+   * 
+   * See TTimer::getSkipped(), the number is reset by pulse() and oscillate().
+   */
+  unsigned int getSkipped();
+  
+  /**
+   * \brief Get the time until the pin needs to be looped again.
+   * 
+   * Returns the time until the next state change of a pulse, zero while oscillating
+   * or TDUINO_NOT_DUE if no task is active.
+   * 
+   * \see TBase::nextDueIn()
+   */
+  virtual unsigned long nextDueIn();
+  
   /**
 	* \brief The extended pins loop phase.
 	* 
@@ -0,0 +1,89 @@
+/*
+  
+  Copyright © 2018 - Torben Bruchhaus
+  TDuino.bruchhaus.dk - github.com/bswebdk/TDuino
+  File: TSlotHandle.cpp
+  
+  This program is free software: you can redistribute it and/or modify
+  it under the terms of the GNU Lesser General Public License as published
+  by the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+  
+  This program is distributed in the hope that it will be useful, but
+  WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+  Lesser General Public License for more details.
+  
+  You should have received a copy of the GNU Lesser General Public License
+  along with this program.  If not, see <http://www.gnu.org/licenses/>
+  
+*/
+
+#include "TSlotHandle.h"
+
+TSlotAllocator::TSlotAllocator()
+{
+  owners = NULL;
+  size = 0;
+  head = TSLOT_NONE;
+}
+
+TSlotAllocator::~TSlotAllocator()
+{
+  if (owners) delete[] owners;
+}
+
+void TSlotAllocator::begin(byte size)
+{
+  owners = new TSLOT_OWNER[size];
+  this->size = size;
+  head = TSLOT_NONE;
+  //Slots are marked as allocated (odd) until pushed, so slots in use by index are never handed out
+  for (byte i = 0; i < size; i++)
+  {
+    owners[i].generation = 1;
+    owners[i].next = TSLOT_NONE;
+  }
+}
+
+void TSlotAllocator::push(byte index)
+{
+  owners[index].generation++; //Even while free
+  owners[index].next = head;
+  head = index;
+}
+
+TSlotHandle TSlotAllocator::allocate()
+{
+  TSlotHandle handle = { TSLOT_NONE, 0 };
+  if (head == TSLOT_NONE) return handle;
+  handle.index = head;
+  head = owners[head].next;
+  handle.generation = ++owners[handle.index].generation;
+  return handle;
+}
+
+bool TSlotAllocator::release(TSlotHandle handle)
+{
+  if (!isValid(handle)) return false;
+  push(handle.index);
+  return true;
+}
+
+byte TSlot_Next(const byte *bits, byte from, byte count, bool set)
+{
+  if (from >= count) return TSLOT_NONE;
+  byte b = from >> 3, last = (count - 1) >> 3, flip = set ? 0 : 0xFF;
+  byte v = (bits[b] ^ flip) & (0xFF << (from & 7));
+  while (!v)
+  {
+    if (++b > last) return TSLOT_NONE;
+    v = bits[b] ^ flip;
+  }
+#ifdef __GNUC__
+  from = (b << 3) + __builtin_ctz(v);
+#else
+  for (from = b << 3; !(v & 1); v >>= 1) from++;
+#endif
+  return (from < count) ? from : TSLOT_NONE;
+}
@@ -0,0 +1,91 @@
+/*
+  
+  Copyright © 2018 - Torben Bruchhaus
+  TDuino.bruchhaus.dk - github.com/bswebdk/TDuino
+  File: TSlotHandle.h
+  
+  This program is free software: you can redistribute it and/or modify
+  it under the terms of the GNU Lesser General Public License as published
+  by the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+  
+  This program is distributed in the hope that it will be useful, but
+  WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+  Lesser General Public License for more details.
+  
+  You should have received a copy of the GNU Lesser General Public License
+  along with this program.  If not, see <http://www.gnu.org/licenses/>
+  
+*/
+
+#ifndef TSLOTHANDLE_H
+#define TSLOTHANDLE_H
+
+#include "TDefs.h"
+
+/**
+ * \brief Handle of a slot allocated with TTimer::allocate() or TTimeline::allocate().
+ * 
+ * A handle consists of the index of the slot and a generation which changes every time
+ * the slot is allocated or released. When a slot has been released, any handle to it
+ * is rejected (even after the slot has been allocated again), so an old owner cannot
+ * stop or change the slot of a new owner by accident. An invalid handle has the index
+ * #TSLOT_NONE.
+ * 
+ * The generation is 16 bits and changes twice for each allocation of the slot, so it wraps
+ * after 32768 allocations of the same slot. A handle which is kept that long after its
+ * slot has been released will be accepted again (once the slot is allocated by someone
+ * else), so handles should be dropped when they are released.
+ */
+struct TSlotHandle
+{
+  byte index; ///< The index of the slot
+  uint16_t generation; ///< The generation of the slot (odd while allocated)
+};
+
+/**
+ * \brief Index used by invalid handles.
+ */
+#define TSLOT_NONE 255
+
+/// \cond HIDDEN_FIELD
+
+struct TSLOT_OWNER
+{
+  uint16_t generation;
+  byte next;
+};
+
+//Free list of slots used by TTimer and TTimeline. The free list is linked through the
+//slots themselves and is allocated when the first handle is allocated.
+class TSlotAllocator
+{
+private:
+  TSLOT_OWNER *owners;
+  byte size, head;
+
+public:
+  TSlotAllocator();
+  ~TSlotAllocator();
+  bool isReady() { return owners != NULL; }
+  void begin(byte size);
+  void push(byte index);
+  TSlotHandle allocate();
+  bool release(TSlotHandle handle);
+  bool isValid(TSlotHandle handle) { return (handle.index < size) && (owners[handle.index].generation == handle.generation) && (handle.generation & 1); }
+};
+
+//Bitmap of the active slots used by TTimer and TTimeline, one bit per slot
+#define TSLOT_BYTES(n) (((n) + 7) >> 3)
+inline bool TSlot_Test(const byte *bits, byte index) { return (bits[index >> 3] >> (index & 7)) & 1; }
+inline void TSlot_Set(byte *bits, byte index) { bits[index >> 3] |= (1 << (index & 7)); }
+inline void TSlot_Clear(byte *bits, byte index) { bits[index >> 3] &= ~(1 << (index & 7)); }
+
+//Returns the first slot from "from" (and below "count") which is set (or cleared if "set"
+//is false) in the bitmap or TSLOT_NONE. Whole bytes are skipped at once.
+byte TSlot_Next(const byte *bits, byte from, byte count, bool set = true);
+
+/// \endcond
+
+#endif //TSLOTHANDLE_H
@@ -22,14 +22,43 @@
 #include "TTimeline.h"
 
 #define MAP_PCT(pct, low, high) roundf((float)(high - low) * pct) + low
-#define RESTART(t) t->start = loopMillis; t->state = (t->after == 0) ? TL_STATE_ACTIVE : TL_STATE_POSTPONED
+#define FIRE(i, p) if (handlers && handlers[i].handler) handlers[i].handler(handlers[i].context, i, p); else (*callback)(i, p)
+#define FIRE_PROGRESS(i, p) if (handlers && handlers[i].progressHandler) handlers[i].progressHandler(handlers[i].context, i, p); else (*progressCallback)(i, p)
+
+#ifdef ENABLE_COMPACT_SLOTS
+  #define FULL_START(t) (loopMillis - TL_ELAPSED(t))
+#else
+  #define FULL_START(t) (t)->start
+#endif
+
+#define RESTART(i) slots[i].start = loopMillis; slots[i].state = (slots[i].after == 0) ? TL_STATE_ACTIVE : TL_STATE_POSTPONED; TSlot_Set(activeBits, i)
 
 int TL_MapToInt(float progress, int low, int high) { return MAP_PCT(progress, low, high); }
 unsigned int TL_MapToUInt(float progress, unsigned int low, unsigned int high) { return MAP_PCT(progress, low, high); }
 long TL_MapToLong(float progress, long low, long high) { return MAP_PCT(progress, low, high); }
-unsigned long TL_MapToLong(float progress, unsigned long low, unsigned long high) { return MAP_PCT(progress, low, high); }
+unsigned long TL_MapToULong(float progress, unsigned long low, unsigned long high) { return MAP_PCT(progress, low, high); }
 float TL_MapToFloat(float progress, float low, float high) { return ((high - low) * progress) + low; }
 
+//Returns round(range * progress / TL_PROGRESS_MAX) using 32 bit math only. Progress is
+//stretched to 0..65536 so that TL_PROGRESS_MAX maps to the full range.
+unsigned long TL_ScaleProgress(unsigned int progress, unsigned long range)
+{
+  uint32_t p = (uint32_t)progress + (progress >> 15);
+  return (((uint32_t)range >> 16) * p) + ((((uint32_t)range & 0xFFFF) * p + 0x8000) >> 16);
+}
+
+#define MAP_FIX(pct, low, high, utype) (high >= low) ? low + (utype)TL_ScaleProgress(pct, (utype)high - (utype)low) : low - (utype)TL_ScaleProgress(pct, (utype)low - (utype)high)
+
+int TL_MapFixToInt(unsigned int progress, int low, int high) { return MAP_FIX(progress, low, high, unsigned int); }
+unsigned int TL_MapFixToUInt(unsigned int progress, unsigned int low, unsigned int high) { return MAP_FIX(progress, low, high, unsigned int); }
+long TL_MapFixToLong(unsigned int progress, long low, long high) { return MAP_FIX(progress, low, high, unsigned long); }
+unsigned long TL_MapFixToULong(unsigned int progress, unsigned long low, unsigned long high) { return MAP_FIX(progress, low, high, unsigned long); }
+float TL_MapFixToFloat(unsigned int progress, float low, float high) { return ((high - low) * (progress * (1.0f / TL_PROGRESS_MAX))) + low; }
+
+//Used as a dummy when the time line is constructed without a callback
+static void dummy_timeline_callback(byte i UNUSED_ATTR, float p UNUSED_ATTR) {}
+static void dummy_progress_callback(byte i UNUSED_ATTR, unsigned int p UNUSED_ATTR) {}
+
 #ifdef TDUINO_DEBUG
 bool TTimeline::badIndex(byte i, const char *token)
 {
@@ -51,45 +80,83 @@ void TTimeline::checkMemError(const char *token)
 #endif
   
 TTimeline::TTimeline(void(*callback)(byte,float), byte numSlots) : TBase()
+{
+  init(numSlots, NULL, NULL);
+  this->callback = callback ? callback : dummy_timeline_callback;
+}
+
+TTimeline::TTimeline(void(*callback)(byte,unsigned int), byte numSlots) : TBase()
+{
+  init(numSlots, NULL, NULL);
+  this->progressCallback = callback ? callback : dummy_progress_callback;
+}
+
+#if TDUINO_TIMELINE_SIZE == 0
+TTimeline::TTimeline(void(*callback)(byte,float), TTIMELINE_SLOT *storage, byte *activeBits, byte numSlots) : TBase()
+{
+  init(numSlots, storage, activeBits);
+  this->callback = callback ? callback : dummy_timeline_callback;
+}
+
+TTimeline::TTimeline(void(*callback)(byte,unsigned int), TTIMELINE_SLOT *storage, byte *activeBits, byte numSlots) : TBase()
+{
+  init(numSlots, storage, activeBits);
+  this->progressCallback = callback ? callback : dummy_progress_callback;
+}
+#endif
+
+void TTimeline::init(byte numSlots, TTIMELINE_SLOT *storage, byte *activeBits)
 {
 #if TDUINO_TIMELINE_SIZE > 0
-  //Silence the warning
+  //Silence the warnings
   numSlots++;
+  storage++;
+  activeBits++;
 #else  
   this->numSlots = (numSlots < 1) ? 1 : numSlots;
   #ifdef TDUINO_DEBUG
-    if (freeRam() < ((this->numSlots * 13) + 2))
+    this->memError = 0;
+    if ((!storage) && (freeRam() < (int)((this->numSlots * sizeof(TTIMELINE_SLOT)) + TSLOT_BYTES(this->numSlots) + 2)))
     {
       this->memError = this->numSlots;
       this->numSlots = 1;
     }
-    else this->memError = 0;
   #endif // TDUINO_DEBUG
-  this->slots = new TTIMELINE_SLOT[this->numSlots];
+  this->ownSlots = (storage == NULL);
+  this->slots = storage ? storage : new TTIMELINE_SLOT[this->numSlots];
+  this->activeBits = storage ? activeBits : new byte[TSLOT_BYTES(this->numSlots)];
 #endif //TDUINO_TIMELINE_SIZE
-  this->callback = callback;
+  this->callback = NULL;
+  this->progressCallback = NULL;
+  this->handlers = NULL;
   memset(this->slots, 0, sizeof(TTIMELINE_SLOT) * this->numSlots);
+  memset(this->activeBits, 0, TSLOT_BYTES(this->numSlots));
 }
 
 TTimeline::~TTimeline()
 {
+  if (this->handlers) delete[] this->handlers;
 #if TDUINO_TIMELINE_SIZE > 0
   //Nothing
 #else
-  delete[] this->slots;
+  if (this->ownSlots)
+  {
+    delete[] this->slots;
+    delete[] this->activeBits;
+  }
 #endif
 }
 
 int TTimeline::firstActive()
 {
-  for (dummy = 0; dummy < numSlots; dummy++) if (isActive(dummy)) return dummy;
-  return -1;
+  dummy = TSlot_Next(activeBits, 0, numSlots);
+  return (dummy == TSLOT_NONE) ? -1 : dummy;
 }
 
 int TTimeline::firstInactive()
 {
-  for (dummy = 0; dummy < numSlots; dummy++) if (!isActive(dummy)) return dummy;
-  return -1;
+  dummy = TSlot_Next(activeBits, 0, numSlots, false);
+  return (dummy == TSLOT_NONE) ? -1 : dummy;
 }
 
 byte TTimeline::getSize()
@@ -110,18 +177,19 @@ char TTimeline::hasOverlap(byte index1, byte index2, bool remove)
   current = &this->slots[index1];
   TTIMELINE_SLOT *tls = &this->slots[index2];
   if ((current->state == TL_STATE_INACTIVE) || (tls->state == TL_STATE_INACTIVE)) return 0;
+  unsigned long s1 = FULL_START(current), s2 = FULL_START(tls);
 
 #ifdef ENABLE_64BIT
-  uint64_t v1 = current->start, v2 = tls->start;
+  uint64_t v1 = s1, v2 = s2;
 #else
   #ifndef DISABLE_32BIT_ROLLOVER_CHECKS
     #define RO_CHECK
   #endif
   unsigned long v1, v2, st;
   //If using 32 bit, subtract the lowest starting value in order to reduce the risk of rollover
-  st = (current->start < tls->start) ? current->start : tls->start;
-  v1 = current->start - st;
-  v2 = tls->start - st;
+  st = (s1 < s2) ? s1 : s2;
+  v1 = s1 - st;
+  v2 = s2 - st;
 #endif
   
   //Add postponation
@@ -166,15 +234,18 @@ char TTimeline::hasOverlap(byte index1, byte index2, bool remove)
     {
       //1 must be postponed
     #ifdef ENABLE_64BIT
-      v1 = (v2 + tls->duration) - current->start;
+      v1 = (v2 + tls->duration) - s1;
       if (v1 > 0xFFFFFFFFUL) RO_ERROR(index1, -1);//return -1; //Exceeds 32 bit limits
     #else
-      v1 = (v2 + tls->duration) - (current->start - st);
+      v1 = (v2 + tls->duration) - (s1 - st);
     #endif
       /*Serial.print("1 from ");
       Serial.print(current->after);
       Serial.print(" to ");
       Serial.println(v1);*/
+    #ifdef ENABLE_COMPACT_SLOTS
+      if (v1 > 0xFFFF) RO_ERROR(index1, -1); //Exceeds 16 bit limits
+    #endif
       current->after = v1;
     }
       
@@ -182,15 +253,18 @@ char TTimeline::hasOverlap(byte index1, byte index2, bool remove)
     {
       //2 must be postponed
     #ifdef ENABLE_64BIT
-      v2 = (v1 + current->duration) - tls->start;
+      v2 = (v1 + current->duration) - s2;
       if (v2 > 0xFFFFFFFFUL) RO_ERROR(index2, -2);//return -2; //Exceeds 32 bit limits
     #else
-      v2 = (v1 + current->duration) - (tls->start - st);
+      v2 = (v1 + current->duration) - (s2 - st);
     #endif
       /*Serial.print("2 from ");
       Serial.print(tls->after);
       Serial.print(" to ");
       Serial.println(v2);*/
+    #ifdef ENABLE_COMPACT_SLOTS
+      if (v2 > 0xFFFF) RO_ERROR(index2, -2); //Exceeds 16 bit limits
+    #endif
       tls->after = v2;
     }
       
@@ -203,7 +277,7 @@ bool TTimeline::isActive(byte index)
 #ifdef TDUINO_DEBUG
   if (badIndex(index, PSTR("isActive"))) return false;
 #endif
-  return (slots[index].state == TL_STATE_ACTIVE) || (slots[index].state == TL_STATE_POSTPONED);
+  return TSlot_Test(activeBits, index);
 }
 
 bool TTimeline::isStarted(byte index)
@@ -224,7 +298,7 @@ void TTimeline::restart(byte index)
 #else
   current = &slots[index];
 #endif
-  RESTART(current);
+  RESTART(index);
 }
 
 void TTimeline::restartAll()
@@ -236,13 +310,125 @@ void TTimeline::set(byte index, unsigned long duration, unsigned long startAfter
 {
 #ifdef TDUINO_DEBUG
   if (badIndex(index, PSTR("set"))) return;
+#endif
+#ifdef ENABLE_COMPACT_SLOTS
+  if ((duration > 0xFFFF) || (startAfter > 0xFFFF))
+  {
+  #ifdef TDUINO_DEBUG
+    TDuino_Error(TDUINO_ERROR_BAD_PARAMETER, index, PSTR("set"));
+  #endif
+    if (duration > 0xFFFF) duration = 0xFFFF;
+    if (startAfter > 0xFFFF) startAfter = 0xFFFF;
+  }
 #endif
   current = &slots[index];
   current->after = startAfter;
   current->duration = duration;
+  current->reciprocal = (duration == 0) ? 0 : 0xFFFFFFFFUL / (uint32_t)duration;
   //current->start = loopMillis;
   //current->state = (startAfter == 0) ? TL_STATE_ACTIVE : TL_STATE_POSTPONED;
-  RESTART(current);
+  RESTART(index);
+}
+
+unsigned long TTimeline::nextDueIn()
+{
+  unsigned long due = TDUINO_NOT_DUE, e;
+  for (byte i = TSlot_Next(activeBits, 0, numSlots); i != TSLOT_NONE; i = TSlot_Next(activeBits, i + 1, numSlots))
+  {
+    current = &slots[i];
+    if (current->state == TL_STATE_ACTIVE) return 0;
+    if (current->state == TL_STATE_POSTPONED)
+    {
+      e = TL_ELAPSED(current);
+      if (e >= current->after) return 0;
+      if (current->after - e < due) due = current->after - e;
+    }
+  }
+  return due;
+}
+
+void TTimeline::setHandler(byte index, void *context)
+{
+  if (!handlers)
+  {
+    handlers = new TTIMELINE_HANDLER[numSlots];
+    memset(handlers, 0, sizeof(TTIMELINE_HANDLER) * numSlots);
+  }
+  handlers[index].context = context;
+}
+
+void TTimeline::setHandler(byte index, TTimelineHandler handler, void *context)
+{
+#ifdef TDUINO_DEBUG
+  if (badIndex(index, PSTR("setHandler"))) return;
+  if (progressCallback) TDuino_Error(TDUINO_ERROR_INVALID_OPERATION, index, PSTR("setHandler"));
+#endif
+  if (!handlers && !handler) return;
+  setHandler(index, context);
+  handlers[index].handler = handler;
+}
+
+void TTimeline::setHandler(byte index, TTimelineProgressHandler handler, void *context)
+{
+#ifdef TDUINO_DEBUG
+  if (badIndex(index, PSTR("setHandler"))) return;
+  if (!progressCallback) TDuino_Error(TDUINO_ERROR_INVALID_OPERATION, index, PSTR("setHandler"));
+#endif
+  if (!handlers && !handler) return;
+  setHandler(index, context);
+  handlers[index].progressHandler = handler;
+}
+
+bool TTimeline::badHandle(TSlotHandle handle, const char *token UNUSED_ATTR)
+{
+  if (allocator.isValid(handle)) return false;
+#ifdef TDUINO_DEBUG
+  TDuino_Error(TDUINO_ERROR_INVALID_OPERATION, handle.index, token);
+#endif
+  return true;
+}
+
+TSlotHandle TTimeline::allocate()
+{
+  if (!allocator.isReady())
+  {
+    allocator.begin(numSlots);
+    for (byte i = numSlots; i > 0; i--) if (!TSlot_Test(activeBits, i - 1)) allocator.push(i - 1);
+  }
+  return allocator.allocate();
+}
+
+bool TTimeline::release(TSlotHandle handle)
+{
+  if (badHandle(handle, PSTR("release"))) return false;
+  stop(handle.index);
+  if (handlers) handlers[handle.index].handler = NULL;
+  return allocator.release(handle);
+}
+
+bool TTimeline::isValid(TSlotHandle handle)
+{
+  return allocator.isValid(handle);
+}
+
+void TTimeline::set(TSlotHandle handle, unsigned long duration, unsigned long startAfter)
+{
+  if (!badHandle(handle, PSTR("set"))) set(handle.index, duration, startAfter);
+}
+
+bool TTimeline::isActive(TSlotHandle handle)
+{
+  return allocator.isValid(handle) && isActive(handle.index);
+}
+
+void TTimeline::restart(TSlotHandle handle)
+{
+  if (!badHandle(handle, PSTR("restart"))) restart(handle.index);
+}
+
+void TTimeline::stop(TSlotHandle handle)
+{
+  if (!badHandle(handle, PSTR("stop"))) stop(handle.index);
 }
 
 void TTimeline::stop(byte index)
@@ -251,6 +437,7 @@ void TTimeline::stop(byte index)
   if (badIndex(index, PSTR("stop"))) return;
 #endif
   slots[index].state = TL_STATE_INACTIVE;
+  TSlot_Clear(activeBits, index);
 }
 
 void TTimeline::stopAll()
@@ -265,28 +452,53 @@ void TTimeline::loop()
 #endif //TDUINO_DEBUG
 
   TBase::loop();
-  for (byte i = 0; i < numSlots; i++)
+  byte i, bits;
+  for (byte b = 0; b < TSLOT_BYTES(numSlots); b++)
   {
-    current = &this->slots[i];
-    if (current->state == TL_STATE_ACTIVE)
+    for (i = b << 3, bits = activeBits[b]; bits; i++, bits >>= 1)
     {
-      float p = (current->duration == 0) ? 1.0f : (float)(loopMillis - current->start) / (float)current->duration;
-      if (p >= 1.0f)
+      if (!(bits & 1)) continue;
+      current = &this->slots[i];
+      if (current->state == TL_STATE_ACTIVE)
       {
-        p = 1.0f;
-        current->state = TL_STATE_INACTIVE;
+        if (callback)
+        {
+          float p = (current->duration == 0) ? 1.0f : (float)TL_ELAPSED(current) / (float)current->duration;
+          if (p >= 1.0f)
+          {
+            p = 1.0f;
+            current->state = TL_STATE_INACTIVE;
+            TSlot_Clear(activeBits, i);
+          }
+          FIRE(i, p);
+        }
+        else
+        {
+          uint32_t e = TL_ELAPSED(current);
+          unsigned int p;
+          if (e >= current->duration)
+          {
+            p = TL_PROGRESS_MAX;
+            current->state = TL_STATE_INACTIVE;
+            TSlot_Clear(activeBits, i);
+          }
+          else p = (e * current->reciprocal) >> 16; //e * reciprocal < 2^32 since e < duration
+          FIRE_PROGRESS(i, p);
+        }
       }
-      (*callback)(i, p);
+      else if ((current->state == TL_STATE_POSTPONED) && (TL_ELAPSED(current) >= current->after))
+      {
+        #ifdef ENABLE_TIGHT_TIMING
+        current->start += current->after;
+        #else
+        current->start = loopMillis;
+        #endif
+        current->state = TL_STATE_ACTIVE;
+        if (current->duration == 0) continue;
+        if (callback) { FIRE(i, 0.0f); } //Make sure that transition starts from 0.0f
+        else { FIRE_PROGRESS(i, 0); }
+      } 
+      bits = activeBits[b] >> (i & 7); //The callback may start or stop slots
     }
-    else if ((current->state == TL_STATE_POSTPONED) && (loopMillis - current->start >= current->after))
-    {
-      #ifdef ENABLE_TIGHT_TIMING
-      current->start += current->after;
-      #else
-      current->start = loopMillis;
-      #endif
-      current->state = TL_STATE_ACTIVE;
-      if (current->duration > 0) (*callback)(i, 0.0f); //Make sure that transition starts from 0.0f
-    } 
   }
 }
@@ -23,11 +23,17 @@
 #define TTIMELINE_H
 
 #include "TBase.h"
+#include "TSlotHandle.h"
 
 #define TL_STATE_INACTIVE 0
 #define TL_STATE_ACTIVE 1
 #define TL_STATE_POSTPONED 2
 
+/**
+ * \brief The fixed point progress of a completed slot (equals 1.0f).
+ */
+#define TL_PROGRESS_MAX 65535U
+
 /**
  * \file TTimeline.h
  * \defgroup TL_HELPERS Timeline helpers
@@ -42,6 +48,12 @@
  * 
  * The formula is pretty simple: roundf((float)(max - min) * progress) + min
  * 
+ * All functions are also available for the fixed point progress (0..TL_PROGRESS_MAX)
+ * passed to the callback of a TTimeline which is constructed with a fixed point
+ * callback, these are named TL_MapFixTo*. The fixed point versions returning integers
+ * uses no floating point math and no divisions, TL_MapFixToFloat() uses a floating
+ * point multiplication.
+ * 
  * The are functions for signed and unsigned int + long and for float:
  * 
  * \code
@@ -58,6 +70,14 @@
  * }
  * 
  * TTimeline tline(TimelineCallback, 2);
+ * 
+ * void FixedTimelineCallback(byte slot, unsigned int progress)
+ * {
+ *   //Same as above without floating point math
+ *   int intValue = TL_MapFixToInt(progress, 1000, 2000);
+ * }
+ * 
+ * TTimeline fixedLine(FixedTimelineCallback, 2);
  * \endcode
  * 
  * @{
@@ -88,16 +108,81 @@ unsigned long TL_MapToULong(float progress, unsigned long low, unsigned long hig
  */
 float TL_MapToFloat(float progress, float low, float high);
 
+/**
+ * \brief Scale a range by fixed point progress
+ * 
+ * Returns the part of _range_ which corresponds to _progress_, eg. half of the range if
+ * progress is TL_PROGRESS_MAX / 2. Used by the fixed point helpers and TTimelineT.
+ */
+unsigned long TL_ScaleProgress(unsigned int progress, unsigned long range);
+
+/**
+ * \brief Map fixed point progress to int
+ */
+int TL_MapFixToInt(unsigned int progress, int low, int high);
+
+/**
+ * \brief Map fixed point progress to unsigned int
+ */
+unsigned int TL_MapFixToUInt(unsigned int progress, unsigned int low, unsigned int high);
+
+/**
+ * \brief Map fixed point progress to long
+ */
+long TL_MapFixToLong(unsigned int progress, long low, long high);
+
+/**
+ * \brief Map fixed point progress to unsigned long
+ */
+unsigned long TL_MapFixToULong(unsigned int progress, unsigned long low, unsigned long high);
+
+/**
+ * \brief Map fixed point progress to float
+ */
+float TL_MapFixToFloat(unsigned int progress, float low, float high);
+
 /// @}
 
+/**
+ * \brief The handler type used for the slots of TTimeline, receives the context, the slot index and the progress.
+ */
+typedef void (*TTimelineHandler)(void*, byte, float);
+
+/**
+ * \brief The handler type used for the slots of TTimeline using fixed point progress.
+ */
+typedef void (*TTimelineProgressHandler)(void*, byte, unsigned int);
+
 /// \cond HIDDEN_FIELD
 
+struct TTIMELINE_HANDLER
+{
+  union
+  {
+    TTimelineHandler handler;
+    TTimelineProgressHandler progressHandler;
+  };
+  void *context;
+};
+
 struct TTIMELINE_SLOT
 {
+#ifdef ENABLE_COMPACT_SLOTS
+  uint32_t reciprocal; //0xFFFFFFFF / duration
+  uint16_t after, start, duration;
+#else
   unsigned long after, start, duration;
+  uint32_t reciprocal; //0xFFFFFFFF / duration
+#endif
   byte state;
 };
 
+#ifdef ENABLE_COMPACT_SLOTS
+  #define TL_ELAPSED(t) (uint16_t)((uint16_t)loopMillis - (t)->start)
+#else
+  #define TL_ELAPSED(t) (loopMillis - (t)->start)
+#endif
+
 /// \endcond
 
 /**
@@ -125,6 +210,18 @@ struct TTIMELINE_SLOT
  * 
  * See \ref TL_HELPERS for a list of helpers for handling the progres value.
  * 
+ * If the callback takes an unsigned int rather than a float, the progress is passed as
+ * a fixed point value from 0 (start) to TL_PROGRESS_MAX (end). Calculating the fixed point
+ * progress only costs a multiplication and a shift for each slot, which is much faster
+ * than the floating point division used for the float progress on boards without an FPU.
+ * 
+ * \code
+ * void TimelineCallback(byte slot, unsigned int progress)
+ * {
+ *   analogWrite(LED_PIN, TL_MapFixToInt(progress, 0, 255));
+ * }
+ * \endcode
+ * 
  * <b>IMPORTANT NOTE!</b> For most situations you would use the template class
  * \ref TTimelineT because it is more efficient (no floating points). You should
  * only use TTimeline in situations where you need to translate the progress to
@@ -136,14 +233,23 @@ class TTimeline : public TBase
 {
 private:
   void (*callback)(byte, float);
+  void (*progressCallback)(byte, unsigned int);
+  TTIMELINE_HANDLER *handlers;
+  TSlotAllocator allocator;
+  void init(byte numSlots, TTIMELINE_SLOT *storage, byte *activeBits);
+  void setHandler(byte index, void *context);
+  bool badHandle(TSlotHandle handle, const char *token);
   
 protected:
 #if TDUINO_TIMELINE_SIZE > 0
   const byte numSlots = TDUINO_TIMELINE_SIZE;
   TTIMELINE_SLOT slots[TDUINO_TIMELINE_SIZE];
+  byte activeBits[TSLOT_BYTES(TDUINO_TIMELINE_SIZE)];
 #else
   byte numSlots;
   TTIMELINE_SLOT *slots;
+  byte *activeBits;
+  bool ownSlots;
 #endif
   
   TTIMELINE_SLOT *current;
@@ -154,6 +260,25 @@ protected:
   void checkMemError(const char *token);
   byte memError;
 #endif
+
+#if TDUINO_TIMELINE_SIZE == 0
+  /**
+   * \brief Constructs a time line using external memory for the slots.
+   * \param callback The callback which handles time line events.
+   * \param storage The memory used for the slots (must live as long as the time line).
+   * \param activeBits The memory used for the active flags, TSLOT_BYTES(numSlots) bytes.
+   * \param numSlots The number of slots in _storage_.
+   * 
+   * Used by TTimelineN in order to keep the slots inside the object.
+   */
+  TTimeline(void(*callback)(byte,float), TTIMELINE_SLOT *storage, byte *activeBits, byte numSlots);
+  
+  /**
+   * \brief Constructs a time line using fixed point progress and external memory for the slots.
+   * \overload TTimeline(void(*callback)(byte,unsigned int), TTIMELINE_SLOT *storage, byte *activeBits, byte numSlots)
+   */
+  TTimeline(void(*callback)(byte,unsigned int), TTIMELINE_SLOT *storage, byte *activeBits, byte numSlots);
+#endif
   
 public:
   
@@ -165,12 +290,26 @@ public:
    * The callback will be called for each active slot and to it will be passed an
    * index of the slot being handled and the amount of progress for the slot.
    * 
-   * _numSlots_ must be in the range 1..255, memory usage (in bytes) is: (13 * numSlots) + 2.
+   * _numSlots_ must be in the range 1..255, memory usage (in bytes) is: (17 * numSlots) + 2,
+   * or (11 * numSlots) + 2 if ENABLE_COMPACT_SLOTS is defined, plus one bit per slot.
+   * Each slot includes 4 bytes used to calculate the fixed point progress without a
+   * division, these are used by fixed point callbacks and TTimelineT only, but they are
+   * part of the slot regardless of the callback.
    * 
    * \ref static_allocation
    */
   TTimeline(void(*callback)(byte,float), byte numSlots = 1);
   
+  /**
+   * \brief The constructor for a TTimeline using fixed point progress.
+   * \param callback The callback which handles time line events.
+   * \param numSlots The number of slots used by this instance.
+   * 
+   * Same as TTimeline(void(*callback)(byte,float), byte numSlots) except that the progress
+   * passed to the callback is a fixed point value from 0 to TL_PROGRESS_MAX.
+   */
+  TTimeline(void(*callback)(byte,unsigned int), byte numSlots = 1);
+  
   /**
    * \brief The destuctor for a TTimeline
    * 
@@ -294,6 +433,78 @@ public:
    */
   void set(byte index, unsigned long duration, unsigned long startAfter = 0);
   
+  /**
+   * \brief Set a handler for a slot.
+   * \param index The index of the slot.
+   * \param handler The handler or NULL to use the callback of the time line.
+   * \param context Passed as the first argument to the handler.
+   * 
+   * Same as TTimer::setHandler(), the handler is invoked with the context, the index of
+   * the slot and the progress rather than the callback given to the constructor. The
+   * handler must match the progress used by the time line (this overload is for float
+   * progress). Handlers are not used by TTimelineT.
+   * 
+   * \see TDuino_Method
+   */
+  void setHandler(byte index, TTimelineHandler handler, void *context = NULL);
+  
+  /**
+   * \brief Set a handler for a slot using fixed point progress.
+   * \overload setHandler(byte index, TTimelineProgressHandler handler, void *context = NULL)
+   */
+  void setHandler(byte index, TTimelineProgressHandler handler, void *context = NULL);
+  
+  /**
+   * \brief Allocate a free slot.
+   * \return A handle to the slot, the index of the handle is #TSLOT_NONE if no slot is free.
+   * 
+   * Works the same way as TTimer::allocate(), slots which are in use (active or
+   * postponed) when allocate() is called for the first time are never allocated.
+   * 
+   * \see TTimer::allocate() release() isValid()
+   */
+  TSlotHandle allocate();
+  
+  /**
+   * \brief Release a slot allocated with allocate().
+   * \param handle The handle of the slot.
+   * \return False if the handle is not valid.
+   * 
+   * The slot is stopped, its handler (if any) is cleared and the slot is returned to
+   * the free slots.
+   */
+  bool release(TSlotHandle handle);
+  
+  /**
+   * \brief Check if a handle is valid.
+   * \param handle The handle to check.
+   * \return True if the slot of the handle has not been released.
+   */
+  bool isValid(TSlotHandle handle);
+  
+  /**
+   * \brief Same as set(byte index, unsigned long duration, unsigned long startAfter) using a handle.
+   * 
+   * Nothing is done if the handle is not valid.
+   */
+  void set(TSlotHandle handle, unsigned long duration, unsigned long startAfter = 0);
+  
+  /**
+   * \brief Same as isActive(byte index) using a handle.
+   * \return False if the handle is not valid.
+   */
+  bool isActive(TSlotHandle handle);
+  
+  /**
+   * \brief Same as restart(byte index) using a handle.
+   */
+  void restart(TSlotHandle handle);
+  
+  /**
+   * \brief Same as stop(byte index) using a handle.
+   */
+  void stop(TSlotHandle handle);
+  
   /**
    * \brief Stop a slot.
    * \param index Index of the slot to stop.
@@ -309,6 +520,16 @@ public:
    */
   void stopAll();
   
+  /**
+   * \brief Get the time until the time line needs to be looped again.
+   * 
+   * Returns zero if any slot is started (transition in progress), the time until the
+   * first postponed slot starts or TDUINO_NOT_DUE if no slots are active.
+   * 
+   * \see TBase::nextDueIn()
+   */
+  virtual unsigned long nextDueIn();
+  
   /**
    * \brief The TTimeline's loop phase.
    * 
@@ -320,4 +541,45 @@ public:
   
 };
 
+#if TDUINO_TIMELINE_SIZE == 0
+/**
+ * \brief A TTimeline with a fixed number of slots.
+ * 
+ * TTimelineN is a TTimeline where the number of slots is given at compile time and
+ * the slots are stored inside the object rather than in dynamic memory. Unlike
+ * TDUINO_TIMELINE_SIZE (see \ref static_allocation) each instance can have its own
+ * number of slots:
+ * 
+ * \code
+ * TTimelineN<3> fader(fadeCallback);
+ * \endcode
+ * 
+ * Only the slots (and their active flags) are kept inside the object, setHandler() and
+ * allocate() still allocate their per slot data in dynamic memory the first time they
+ * are called.
+ * 
+ * TTimelineN is not available when TDUINO_TIMELINE_SIZE is defined.
+ */
+template <byte SLOTS> class TTimelineN : public TTimeline
+{
+private:
+  TTIMELINE_SLOT storage[SLOTS];
+  byte activeStorage[TSLOT_BYTES(SLOTS)];
+
+public:
+
+  /**
+   * \brief Constructs a time line with _SLOTS_ slots.
+   * \param callback The callback which handles time line events.
+   */
+  TTimelineN(void(*callback)(byte,float)) : TTimeline(callback, storage, activeStorage, SLOTS) {}
+  
+  /**
+   * \brief Constructs a time line with _SLOTS_ slots using fixed point progress.
+   * \param callback The callback which handles time line events.
+   */
+  TTimelineN(void(*callback)(byte,unsigned int)) : TTimeline(callback, storage, activeStorage, SLOTS) {}
+};
+#endif
+
 #endif //TTIMELINE_H
@@ -22,11 +22,10 @@
 #include "TTimelineT.h"
 
 template <class DATATYPE>
-TTimelineT<DATATYPE>::TTimelineT(void(*callback)(byte, DATATYPE), byte numSlots) : TTimeline(NULL, numSlots)
+TTimelineT<DATATYPE>::TTimelineT(void(*callback)(byte, DATATYPE), byte numSlots) : TTimeline((void(*)(byte, float))NULL, numSlots)
 {
   this->callback = callback;
-  this->mapMin = 0;
-  this->mapMax = sizeof(DATATYPE) == 1 ? 255 : 1023;
+  setMinMax(0, sizeof(DATATYPE) == 1 ? 255 : 1023);
 }
 
 template <class DATATYPE>
@@ -34,6 +33,20 @@ void TTimelineT<DATATYPE>::setMinMax(DATATYPE minValue, DATATYPE maxValue)
 {
   this->mapMin = minValue;
   this->mapMax = maxValue;
+  this->mapDescending = maxValue < minValue;
+  //Modular unsigned subtraction gives the distance for any integer type
+  typedef typename TTIMELINET_RANGE<sizeof(DATATYPE)>::type RANGE;
+  this->mapRange = mapDescending ? (RANGE)minValue - (RANGE)maxValue : (RANGE)maxValue - (RANGE)minValue;
+}
+
+//Same as TL_ScaleProgress() using the range type of DATATYPE. Ranges of 8 and 16 bit data
+//types fits in 16 bits, so they only needs a single multiplication.
+template <class DATATYPE>
+typename TTIMELINET_RANGE<sizeof(DATATYPE)>::type TTimelineT<DATATYPE>::scale(unsigned int progress)
+{
+  uint32_t p = (uint32_t)progress + (progress >> 15);
+  if (sizeof(DATATYPE) <= 2) return (((uint32_t)mapRange * p) + 0x8000) >> 16;
+  return ((mapRange >> 16) * p) + ((((mapRange & 0xFFFF) * p) + 0x8000) >> 16);
 }
 
 template <class DATATYPE>
@@ -44,29 +57,41 @@ void TTimelineT<DATATYPE>::loop()
 #endif //TDUINO_DEBUG
 
   TBase::loop();
-  for (byte i = 0; i < numSlots; i++)
+  byte i, bits;
+  for (byte b = 0; b < TSLOT_BYTES(numSlots); b++)
   {
-    current = &this->slots[i];
-    if (current->state == TL_STATE_ACTIVE)
+    for (i = b << 3, bits = this->activeBits[b]; bits; i++, bits >>= 1)
     {
-      DATATYPE p;
-      if (loopMillis - current->start >= current->duration)
+      if (!(bits & 1)) continue;
+      current = &this->slots[i];
+      if (current->state == TL_STATE_ACTIVE)
       {
-        p = mapMax;
-        current->state = TL_STATE_INACTIVE;
+        DATATYPE p;
+        uint32_t e = TL_ELAPSED(current);
+        if (e >= current->duration)
+        {
+          p = mapMax;
+          current->state = TL_STATE_INACTIVE;
+          TSlot_Clear(this->activeBits, i);
+        }
+        else
+        {
+          typename TTIMELINET_RANGE<sizeof(DATATYPE)>::type v = scale((e * current->reciprocal) >> 16);
+          p = mapDescending ? mapMin - (DATATYPE)v : mapMin + (DATATYPE)v;
+        }
+        (*callback)(i, p);
       }
-      else p = map(loopMillis - current->start, 0, current->duration - 1, mapMin, mapMax);
-      (*callback)(i, p);
+      else if ((current->state == TL_STATE_POSTPONED) && (TL_ELAPSED(current) >= current->after))
+      {
+      #ifdef ENABLE_TIGHT_TIMING
+        current->start += current->after;
+      #else
+        current->start = loopMillis;
+      #endif
+        current->state = TL_STATE_ACTIVE;
+        if (current->duration > 0) (*callback)(i, mapMin); //Make sure that transition starts from mapMin
+      } 
+      bits = this->activeBits[b] >> (i & 7); //The callback may start or stop slots
     }
-    else if ((current->state == TL_STATE_POSTPONED) && (loopMillis - current->start >= current->after))
-    {
-    #ifdef ENABLE_TIGHT_TIMING
-      current->start += current->after;
-    #else
-      current->start = loopMillis;
-    #endif
-      current->state = TL_STATE_ACTIVE;
-      if (current->duration > 0) (*callback)(i, mapMin); //Make sure that transition starts from mapMin
-    } 
   }
 }
@@ -24,6 +24,14 @@
 
 #include "TTimeline.h"
 
+/// \cond HIDDEN_FIELD
+
+//The unsigned type used for the range of TTimelineT, wide enough for any DATATYPE
+template <byte SIZE> struct TTIMELINET_RANGE { typedef uint32_t type; };
+template <> struct TTIMELINET_RANGE<8> { typedef uint64_t type; };
+
+/// \endcond
+
 /**
  * \brief Used to track actions on a virtual time line and map them to a value.
  * 
@@ -33,8 +41,11 @@
  * 
  * The difference between TTimeline and TTimelineT is that TTimelineT is a
  * template class which allows you to map any progress to a certain data type.
- * Since no floating point operations are used in TTimelineT it may in most
- * cases be more efficient that the TTimeline class.
+ * Since no floating point operations or divisions are used in TTimelineT it may
+ * in most cases be more efficient that the TTimeline class. The progress is
+ * calculated in fixed point using the slope (reciprocal of the duration) stored in each
+ * slot and scaled to the range set with setMinMax(). For 8 and 16 bit data types this
+ * costs two multiplications per slot and loop, three for wider data types.
  * 
  * \code
  * void TimelineCallback(byte slot, <DATATYPE> value)
@@ -62,6 +73,9 @@ template <class DATATYPE> class TTimelineT : public TTimeline
 private:
   void (*callback)(byte, DATATYPE);
   DATATYPE mapMin, mapMax;
+  typename TTIMELINET_RANGE<sizeof(DATATYPE)>::type mapRange;
+  bool mapDescending;
+  typename TTIMELINET_RANGE<sizeof(DATATYPE)>::type scale(unsigned int progress);
   
 public:
   
@@ -78,6 +92,7 @@ public:
   using TTimeline::hasOverlap;
   using TTimeline::isActive;
   using TTimeline::isStarted;
+  using TTimeline::nextDueIn;
   using TTimeline::restart;
   using TTimeline::restartAll;
   
@@ -21,7 +21,19 @@
 
 #include "TTimer.h"
 
-#define RESTART(t) t->lastMillis = loopMillis; t->count=0; t->active=true;
+#define IS_ACTIVE(i) TSlot_Test(activeBits, i)
+#define ACTIVATE(i) TSlot_Set(activeBits, i)
+#define DEACTIVATE(i) TSlot_Clear(activeBits, i)
+
+#ifdef ENABLE_COMPACT_SLOTS
+  #define ELAPSED(t) (uint16_t)((uint16_t)loopMillis - t->lastMillis)
+#else
+  #define ELAPSED(t) (loopMillis - t->lastMillis)
+#endif
+
+#define RESTART(i) timers[i].lastMillis = loopMillis; timers[i].count=0; ACTIVATE(i); if (timing) timing[i].skipped = 0;
+#define DUE_IN(t) (long)(t->lastMillis + t->interval - loopMillis)
+#define REMAINING(t) ((ELAPSED(t) >= t->interval) ? 0 : (unsigned long)(t->interval - ELAPSED(t)))
 
 /*----------------------------------------------------------------------*/
 /*----------------------------------------------------------------------*/
@@ -35,6 +47,253 @@ bool TTimer::badIndex(byte index, const char* token)
   return true;
 }
 #endif
+
+#ifdef TTIMER_DEADLINE_ORDER
+
+//The active slots are kept in a binary min-heap ordered by deadline. The heap array is
+//spread over the slots (entry k is stored in timers[k].heap) and each slot knows its
+//position, so a slot is inserted, removed or moved in O(log n). Slots which have been
+//triggered by loop() are parked at the end of the array (after "fired" is increased).
+#define HEAP(k) timers[k].heap
+#define DEADLINE(i) (timers[i].lastMillis + timers[i].interval)
+#define BEFORE(a, b) ((long)(DEADLINE(a) - DEADLINE(b)) < 0)
+
+void TTimer::place(byte pos, byte index)
+{
+  HEAP(pos) = index;
+  timers[index].pos = pos;
+}
+
+void TTimer::siftUp(byte pos)
+{
+  byte index = HEAP(pos), parent;
+  while (pos > 0)
+  {
+    parent = (pos - 1) >> 1;
+    if (!BEFORE(index, HEAP(parent))) break;
+    place(pos, HEAP(parent));
+    pos = parent;
+  }
+  place(pos, index);
+}
+
+void TTimer::siftDown(byte pos)
+{
+  byte index = HEAP(pos);
+  unsigned int child;
+  while ((child = (pos << 1) + 1) < heapSize)
+  {
+    if ((child + 1 < heapSize) && BEFORE(HEAP(child + 1), HEAP(child))) child++;
+    if (!BEFORE(HEAP(child), index)) break;
+    place(pos, HEAP(child));
+    pos = child;
+  }
+  place(pos, index);
+}
+
+void TTimer::schedule(byte index)
+{
+  byte pos = timers[index].pos;
+  if (pos >= heapSize)
+  {
+    unschedule(index); //Parked by loop()
+    pos = heapSize++;
+    place(pos, index);
+  }
+  //The deadline may have moved either way
+  siftUp(pos);
+  siftDown(timers[index].pos);
+}
+
+void TTimer::unschedule(byte index)
+{
+  byte pos = timers[index].pos, last;
+  if (pos == TTIMER_NONE) return;
+  timers[index].pos = TTIMER_NONE;
+  if (pos < heapSize)
+  {
+    last = HEAP(--heapSize);
+    if (last == index) return;
+    place(pos, last);
+    if ((pos > 0) && BEFORE(last, HEAP((pos - 1) >> 1))) siftUp(pos);
+    else siftDown(pos);
+  }
+  else
+  {
+    last = HEAP(numTimers - fired);
+    fired--;
+    if (last != index) place(pos, last);
+  }
+}
+#elif defined(TTIMER_TIMING_WHEEL)
+
+#define WHEEL_NONE 255
+
+void TTimer::schedule(byte index)
+{
+  unschedule(index);
+  current = &timers[index];
+  uint32_t due = current->lastMillis + current->interval;
+  if ((int32_t)(due - wheelTime) < 0)
+  {
+    //The wheel has already passed the deadline, trigger in the next loop
+    link(index, TTIMER_WHEEL_DUE);
+    return;
+  }
+  
+  //The level is the highest group of bits in which the deadline differs from the wheel
+  uint32_t diff = due ^ wheelTime;
+  byte level = 0;
+  while (diff >= TTIMER_WHEEL_SIZE)
+  {
+    diff >>= TTIMER_WHEEL_BITS;
+    level++;
+  }
+  link(index, (level * TTIMER_WHEEL_SIZE) + ((due >> (level * TTIMER_WHEEL_BITS)) & (TTIMER_WHEEL_SIZE - 1)));
+}
+
+void TTimer::unschedule(byte index)
+{
+  current = &timers[index];
+  if (current->where == WHEEL_NONE) return;
+  if (current->next != WHEEL_NONE) timers[current->next].prev = current->prev;
+  if (current->prev != WHEEL_NONE) timers[current->prev].next = current->next;
+  else
+  {
+    wheel[current->where] = current->next;
+    if ((current->next == WHEEL_NONE) && (current->where < TTIMER_WHEEL_PENDING))
+      wheelMask[current->where / TTIMER_WHEEL_SIZE] &= ~(1U << (current->where % TTIMER_WHEEL_SIZE));
+  }
+  current->where = WHEEL_NONE;
+}
+
+void TTimer::link(byte index, byte where)
+{
+  current = &timers[index];
+  current->where = where;
+  current->prev = WHEEL_NONE;
+  current->next = wheel[where];
+  if (current->next != WHEEL_NONE) timers[current->next].prev = index;
+  wheel[where] = index;
+  if (where < TTIMER_WHEEL_PENDING) wheelMask[where / TTIMER_WHEEL_SIZE] |= (1U << (where % TTIMER_WHEEL_SIZE));
+}
+
+bool TTimer::nextBucket(byte &level, byte &bucket, uint32_t &at)
+{
+  //Find the occupied bucket which is reached first. Slots placed in the current bucket
+  //of a coarse level must be cascaded before anything else, so all levels are examined
+  //and a coarser level wins if two buckets are reached at the same time.
+  byte l, b, shift = 0;
+  uint32_t t;
+  bool found = false;
+  for (l = 0; l < TTIMER_WHEEL_LEVELS; l++)
+  {
+    b = (wheelTime >> shift) & (TTIMER_WHEEL_SIZE - 1);
+    unsigned int m = wheelMask[l] >> b;
+    if ((!m) && (l == TTIMER_WHEEL_LEVELS - 1))
+    {
+      //Buckets before the current one on the top level are reached after a 32 bit rollover
+      m = wheelMask[l];
+      b = 0;
+    }
+    if (m)
+    {
+      b += __builtin_ctz(m);
+      t = (wheelTime & ((uint32_t)0xFFFFFFF0 << shift)) | ((uint32_t)b << shift);
+      if ((!found) || ((int32_t)(t - at) <= 0))
+      {
+        level = l;
+        bucket = b;
+        at = t;
+        found = true;
+      }
+    }
+    shift += TTIMER_WHEEL_BITS;
+  }
+  return found;
+}
+
+#endif
+
+bool TTimer::badHandle(TSlotHandle handle, const char* token UNUSED_ATTR)
+{
+  if (allocator.isValid(handle)) return false;
+#ifdef TDUINO_DEBUG
+  TDuino_Error(TDUINO_ERROR_INVALID_OPERATION, handle.index, token);
+#endif
+  return true;
+}
+
+void TTimer::advance(byte index)
+{
+  TTIMER_SLOT *t = &this->timers[index];
+  TTIMER_TIMING *tt = &this->timing[index];
+  unsigned long late = ELAPSED(t), n;
+  late = (late > t->interval) ? late - t->interval : 0;
+  if ((tt->policy == TDUINO_TIMING_BEST_EFFORT) || (t->interval == 0))
+  {
+    //The missed periods are coalesced into this trigger
+    t->lastMillis = loopMillis;
+    if ((t->interval > 0) && (late >= t->interval)) tt->skipped += late / t->interval;
+    return;
+  }
+  t->lastMillis += t->interval;
+  if ((tt->policy == TDUINO_TIMING_CAPPED) && (late >= t->interval))
+  {
+    //Skip the periods which are due beyond the cap, but keep the phase
+    n = late / t->interval;
+    if (n > tt->cap)
+    {
+      n -= tt->cap;
+      t->lastMillis += n * t->interval;
+      tt->skipped += n;
+    }
+  }
+}
+
+void TTimer::trigger(byte index)
+{
+  //The callback may use the timer, so "current" cannot be trusted afterwards
+  TTIMER_SLOT *t = &this->timers[index];
+#ifdef TTIMER_STATS
+  //Lateness must be found before the slot is advanced
+  unsigned long late = ELAPSED(t), run;
+  late = (late > t->interval) ? late - t->interval : 0;
+  unsigned int missed = timing ? timing[index].skipped : 0;
+#endif
+  if (timing) advance(index);
+  else
+  {
+  #ifdef ENABLE_TIGHT_TIMING
+    t->lastMillis += t->interval;
+  #else 
+    t->lastMillis = loopMillis;
+  #endif
+  }
+#ifdef TTIMER_STATS
+  TTimerStats *s = &this->stats[index];
+  if (timing) missed = timing[index].skipped - missed;
+  #ifdef ENABLE_TIGHT_TIMING
+  else missed = 0;
+  #else
+  else missed = ((t->interval > 0) && (late >= t->interval)) ? late / t->interval : 0;
+  #endif
+  s->fired++;
+  s->missed += missed;
+  s->sumLate += late;
+  if (late > s->maxLate) s->maxLate = (late > 0xFFFF) ? 0xFFFF : late;
+  run = micros();
+#endif
+  t->count++;
+  if (handlers && handlers[index].handler) handlers[index].handler(handlers[index].context, index);
+  else if (callback) (*callback)(index);
+#ifdef TTIMER_STATS
+  run = micros() - run;
+  s->sumRun += run;
+  if (run > s->maxRun) s->maxRun = (run > 0xFFFF) ? 0xFFFF : run;
+#endif
+  if ((t->repeat > 0) && (t->count >= t->repeat)) DEACTIVATE(index);
+}
   
 TTimer::TTimer(void(*callback)(byte), byte numTimers) : TBase()
 {
@@ -44,7 +303,7 @@ TTimer::TTimer(void(*callback)(byte), byte numTimers) : TBase()
 #else
   this->numTimers = (numTimers < 1) ? 1 : numTimers;
   #ifdef TDUINO_DEBUG
-    if (freeRam() < ((this->numTimers * 13) + 2))
+    if (freeRam() < (int)((this->numTimers * sizeof(TTIMER_SLOT)) + TSLOT_BYTES(this->numTimers) + 2))
     {
       this->memError = this->numTimers;
       this->numTimers = 1;
@@ -52,30 +311,79 @@ TTimer::TTimer(void(*callback)(byte), byte numTimers) : TBase()
     else this->memError = 0;
   #endif // TDUINO_DEBUG
   this->timers = new TTIMER_SLOT[this->numTimers];
+  this->activeBits = new byte[TSLOT_BYTES(this->numTimers)];
+  this->ownSlots = true;
 #endif //TDUINO_TIMER_SIZE
+  init(callback);
+}
+
+#if TDUINO_TIMER_SIZE == 0
+TTimer::TTimer(void(*callback)(byte), TTIMER_SLOT *slots, byte *activeBits, byte numTimers) : TBase()
+{
+  this->numTimers = numTimers;
+  this->timers = slots;
+  this->activeBits = activeBits;
+  this->ownSlots = false;
+#ifdef TDUINO_DEBUG
+  this->memError = 0;
+#endif
+  init(callback);
+}
+#endif
+
+void TTimer::init(void(*callback)(byte))
+{
   this->callback = callback;
+  this->handlers = NULL;
+  this->timing = NULL;
+#ifdef TTIMER_STATS
+  #if TDUINO_TIMER_SIZE == 0
+  this->stats = new TTimerStats[this->numTimers];
+  #endif
+  resetStats();
+#endif
   memset(this->timers, 0, sizeof(TTIMER_SLOT) * this->numTimers);
+  memset(this->activeBits, 0, TSLOT_BYTES(this->numTimers));
+#ifdef TTIMER_DEADLINE_ORDER
+  this->heapSize = 0;
+  this->fired = 0;
+  for (dummy = 0; dummy < this->numTimers; dummy++) this->timers[dummy].pos = TTIMER_NONE;
+#elif defined(TTIMER_TIMING_WHEEL)
+  this->wheelTime = loopMillis;
+  memset(this->wheelMask, 0, sizeof(this->wheelMask));
+  memset(this->wheel, WHEEL_NONE, sizeof(this->wheel));
+  for (dummy = 0; dummy < this->numTimers; dummy++) this->timers[dummy].where = WHEEL_NONE;
+#endif
 }
 
 TTimer::~TTimer()
 {
+  if (this->handlers) delete[] this->handlers;
+  if (this->timing) delete[] this->timing;
+#if defined(TTIMER_STATS) && (TDUINO_TIMER_SIZE == 0)
+  delete[] this->stats;
+#endif
 #if TDUINO_TIMER_SIZE > 0
   //Nothing
 #else
-  delete[] this->timers;
+  if (this->ownSlots)
+  {
+    delete[] this->timers;
+    delete[] this->activeBits;
+  }
 #endif
 }
 
 int TTimer::firstActive()
 {
-  for (dummy = 0; dummy < numTimers; dummy++) if (timers[dummy].active) return dummy;
-  return -1;
+  dummy = TSlot_Next(activeBits, 0, numTimers);
+  return (dummy == TSLOT_NONE) ? -1 : dummy;
 }
 
 int TTimer::firstInactive()
 {
-  for (dummy = 0; dummy < numTimers; dummy++) if (!timers[dummy].active) return dummy;
-  return -1;
+  dummy = TSlot_Next(activeBits, 0, numTimers, false);
+  return (dummy == TSLOT_NONE) ? -1 : dummy;
 }
 
 
@@ -95,6 +403,29 @@ unsigned long TTimer::getInterval(byte index)
   return timers[index].interval;
 }
 
+unsigned int TTimer::getSkipped(byte index)
+{
+#ifdef TDUINO_DEBUG
+  if (badIndex(index, PSTR("getSkipped"))) return 0;
+#endif
+  return timing ? timing[index].skipped : 0;
+}
+
+#ifdef TTIMER_STATS
+TTimerStats TTimer::getStats(byte index)
+{
+#ifdef TDUINO_DEBUG
+  if (badIndex(index, PSTR("getStats"))) index = 0;
+#endif
+  return stats[index];
+}
+
+void TTimer::resetStats()
+{
+  memset(this->stats, 0, sizeof(TTimerStats) * this->numTimers);
+}
+#endif
+
 byte TTimer::getSize()
 {
   return numTimers;
@@ -105,17 +436,19 @@ bool TTimer::isActive(byte index)
 #ifdef TDUINO_DEBUG
   if (badIndex(index, PSTR("isActive"))) return false;
 #endif
-  return this->timers[index].active;
+  return IS_ACTIVE(index);
 }
 
 void TTimer::restart(byte index)
 {
 #ifdef TDUINO_DEBUG
   if (badIndex(index, PSTR("restart"))) return;
-  if (this->timers[index].active) TDuino_Warning(TDUINO_WARNING_RESUME_ACTIVE, index, PSTR("restart"));
+  if (IS_ACTIVE(index)) TDuino_Warning(TDUINO_WARNING_RESUME_ACTIVE, index, PSTR("restart"));
+#endif
+  RESTART(index);
+#ifdef TTIMER_SCHEDULED
+  schedule(index);
 #endif
-  current = &this->timers[index];
-  RESTART(current);
 }
 
 void TTimer::restartAll()
@@ -127,12 +460,15 @@ void TTimer::resume(byte index)
 {
 #ifdef TDUINO_DEBUG
   if (badIndex(index, PSTR("resume"))) return;
-  if (this->timers[index].active) TDuino_Warning(TDUINO_WARNING_RESUME_ACTIVE, index, PSTR("resume"));
+  if (IS_ACTIVE(index)) TDuino_Warning(TDUINO_WARNING_RESUME_ACTIVE, index, PSTR("resume"));
 #endif
   //current = &this->timers[index];
   //current->lastMillis = loopMillis;
   //current->active = true;
-  this->timers[index].active = true;
+  ACTIVATE(index);
+#ifdef TTIMER_SCHEDULED
+  schedule(index);
+#endif
 }
 
 void TTimer::resumeAll()
@@ -144,20 +480,142 @@ void TTimer::set(byte index, unsigned long interval, unsigned int repetitions)
 {
 #ifdef TDUINO_DEBUG
   if (badIndex(index, PSTR("set"))) return;
+#endif
+#ifdef ENABLE_COMPACT_SLOTS
+  if (interval > 0xFFFF)
+  {
+  #ifdef TDUINO_DEBUG
+    TDuino_Error(TDUINO_ERROR_BAD_PARAMETER, index, PSTR("set"));
+  #endif
+    interval = 0xFFFF;
+  }
 #endif
   current = &timers[index];
   current->interval = interval;
   current->repeat = repetitions;
-  RESTART(current);
+  RESTART(index);
+#ifdef TTIMER_SCHEDULED
+  schedule(index);
+#endif
 }
 void TTimer::set(unsigned long interval, unsigned int repetitions) { set(0, interval, repetitions); }
 
+void TTimer::setHandler(byte index, TTimerHandler handler, void *context)
+{
+#ifdef TDUINO_DEBUG
+  if (badIndex(index, PSTR("setHandler"))) return;
+#endif
+  if (!handlers)
+  {
+    if (!handler) return;
+    handlers = new TTIMER_HANDLER[numTimers];
+    memset(handlers, 0, sizeof(TTIMER_HANDLER) * numTimers);
+  }
+  handlers[index].handler = handler;
+  handlers[index].context = context;
+}
+
+void TTimer::setTiming(byte index, byte policy, byte cap)
+{
+#ifdef TDUINO_DEBUG
+  if (badIndex(index, PSTR("setTiming"))) return;
+  if (policy > TDUINO_TIMING_CAPPED)
+  {
+    TDuino_Error(TDUINO_ERROR_BAD_PARAMETER, policy, PSTR("setTiming"));
+    return;
+  }
+#endif
+  if (!timing)
+  {
+    timing = new TTIMER_TIMING[numTimers];
+    for (dummy = 0; dummy < numTimers; dummy++)
+    {
+      timing[dummy].policy = TDUINO_TIMING_DEFAULT;
+      timing[dummy].cap = 0;
+      timing[dummy].skipped = 0;
+    }
+  }
+  timing[index].policy = policy;
+  timing[index].cap = cap;
+}
+
 void TTimer::stop(byte index)
 {
 #ifdef TDUINO_DEBUG
   if (badIndex(index, PSTR("stop"))) return;
 #endif
-  this->timers[index].active = false;
+  DEACTIVATE(index);
+#ifdef TTIMER_SCHEDULED
+  unschedule(index);
+#endif
+}
+
+TSlotHandle TTimer::allocate()
+{
+  if (!allocator.isReady())
+  {
+    allocator.begin(numTimers);
+    for (byte i = numTimers; i > 0; i--) if (!IS_ACTIVE(i - 1)) allocator.push(i - 1);
+  }
+  return allocator.allocate();
+}
+
+bool TTimer::release(TSlotHandle handle)
+{
+  if (badHandle(handle, PSTR("release"))) return false;
+  stop(handle.index);
+  if (handlers) handlers[handle.index].handler = NULL;
+  if (timing) timing[handle.index].policy = TDUINO_TIMING_DEFAULT;
+  return allocator.release(handle);
+}
+
+bool TTimer::isValid(TSlotHandle handle)
+{
+  return allocator.isValid(handle);
+}
+
+void TTimer::set(TSlotHandle handle, unsigned long interval, unsigned int repetitions)
+{
+  if (!badHandle(handle, PSTR("set"))) set(handle.index, interval, repetitions);
+}
+
+bool TTimer::isActive(TSlotHandle handle)
+{
+  return allocator.isValid(handle) && IS_ACTIVE(handle.index);
+}
+
+void TTimer::restart(TSlotHandle handle)
+{
+  if (!badHandle(handle, PSTR("restart"))) restart(handle.index);
+}
+
+void TTimer::stop(TSlotHandle handle)
+{
+  if (!badHandle(handle, PSTR("stop"))) stop(handle.index);
+}
+
+unsigned long TTimer::nextDueIn()
+{
+  unsigned long due = TDUINO_NOT_DUE;
+#ifdef TTIMER_DEADLINE_ORDER
+  if (heapSize > 0)
+  {
+    current = &this->timers[HEAP(0)];
+    due = REMAINING(current);
+  }
+#elif defined(TTIMER_TIMING_WHEEL)
+  if (wheel[TTIMER_WHEEL_DUE] != WHEEL_NONE) return 0;
+  byte level = 0, bucket = 0;
+  uint32_t at = 0;
+  if (nextBucket(level, bucket, at)) due = ((int32_t)(at - (uint32_t)loopMillis) > 0) ? at - (uint32_t)loopMillis : 0;
+#else
+  for (byte i = TSlot_Next(activeBits, 0, numTimers); (i != TSLOT_NONE) && (due > 0); i = TSlot_Next(activeBits, i + 1, numTimers))
+  {
+    current = &this->timers[i];
+    if (REMAINING(current) < due) due = REMAINING(current);
+  }
+#endif
+  return due;
 }
 
 void TTimer::stopAll()
@@ -176,20 +634,96 @@ void TTimer::loop()
 #endif //TDUINO_DEBUG
 
   TBase::loop();
-  for (byte i = 0; i < this->numTimers; i++)
+#ifdef TTIMER_DEADLINE_ORDER
+  //Only the top of the heap needs to be examined. Triggered slots are parked at the
+  //end of the heap array until all due slots are handled, so each slot triggers once
+  //per loop. "n" ensures that slots restarted by the callback cannot keep the loop busy.
+  byte i;
+  for (byte n = this->numTimers; n && (heapSize > 0); n--)
   {
+    i = HEAP(0);
     current = &this->timers[i];
-    if (current->active && (loopMillis - current->lastMillis >= current->interval))
+    if (loopMillis - current->lastMillis < current->interval) break;
+    unschedule(i);
+    fired++;
+    place(numTimers - fired, i);
+    trigger(i);
+  }
+  while (fired > 0)
+  {
+    i = HEAP(numTimers - fired);
+    fired--;
+    this->timers[i].pos = TTIMER_NONE;
+    if (IS_ACTIVE(i)) schedule(i);
+  }
+#elif defined(TTIMER_TIMING_WHEEL)
+  //Start with the slots which were overdue when they were scheduled
+  byte level = 0, bucket = 0, where = TTIMER_WHEEL_DUE, i;
+  uint32_t at = 0;
+  while (true)
+  {
+    //All slots in the bucket are due, move them to the pending list before triggering
+    //since the callback may start or stop slots. Triggered slots are parked in the
+    //fired list until the wheel is up to date, so each slot triggers once per loop.
+    while (wheel[where] != WHEEL_NONE)
+    {
+      i = wheel[where];
+      unschedule(i);
+      link(i, TTIMER_WHEEL_PENDING);
+    }
+    while (wheel[TTIMER_WHEEL_PENDING] != WHEEL_NONE)
+    {
+      i = wheel[TTIMER_WHEEL_PENDING];
+      unschedule(i);
+      link(i, TTIMER_WHEEL_FIRED);
+      trigger(i);
+    }
+    
+    if (!nextBucket(level, bucket, at))
     {
-    #ifdef ENABLE_TIGHT_TIMING
-      current->lastMillis += current->interval;
-    #else 
-      current->lastMillis = loopMillis;
-    #endif
-      current->count++;
-      (*callback)(i);
-      if ((current->repeat > 0) && (current->count >= current->repeat)) current->active = false; 
+      //The wheel is empty, so it can be moved to any time
+      wheelTime = loopMillis + 1;
+      break;
     }
+    if ((int32_t)((uint32_t)loopMillis - wheelTime) < 0) break;
+    if ((int32_t)((uint32_t)loopMillis - at) < 0)
+    {
+      //Nothing more is due at this time
+      wheelTime = loopMillis + 1;
+      break;
+    }
+    if ((int32_t)(at - wheelTime) > 0) wheelTime = at;
+    where = (level * TTIMER_WHEEL_SIZE) + bucket;
+    if (level > 0)
+    {
+      //Cascade the slots in the bucket to the finer levels
+      while (wheel[where] != WHEEL_NONE) schedule(wheel[where]);
+    }
+    else wheelTime++;
+  }
+  while (wheel[TTIMER_WHEEL_FIRED] != WHEEL_NONE)
+  {
+    i = wheel[TTIMER_WHEEL_FIRED];
+    if (IS_ACTIVE(i)) schedule(i);
+    else unschedule(i);
   }
+#else
+  //Only the active slots are examined and 8 inactive slots are skipped at once, so the
+  //cost depends on the number of active slots rather than the number of slots
+  byte i, bits;
+  for (byte b = 0; b < TSLOT_BYTES(this->numTimers); b++)
+  {
+    for (i = b << 3, bits = activeBits[b]; bits; i++, bits >>= 1)
+    {
+      if (!(bits & 1)) continue;
+      current = &this->timers[i];
+      if (ELAPSED(current) >= current->interval)
+      {
+        trigger(i);
+        bits = activeBits[b] >> (i & 7); //The callback may start or stop slots
+      }
+    }
+  }
+#endif
 }
 
@@ -22,14 +22,75 @@
 #ifndef TTIMER_H
 #define TTIMER_H
 #include "TBase.h"
+#include "TSlotHandle.h"
+
+/**
+ * \brief The handler type used for the slots of TTimer, receives the context and the slot index.
+ */
+typedef void (*TTimerHandler)(void*, byte);
+
+#ifdef TTIMER_STATS
+/**
+ * \brief Statistics of a timer slot, see TTimer::getStats().
+ * 
+ * Lateness is measured in milliseconds (or microseconds, see TIMING_WITH_MICROS) from
+ * the deadline of the slot to the time it is triggered, the execution time of the
+ * callback is always measured in microseconds. The maximums are limited to 65535 and
+ * the counters roll over at 65535, use TTimer::resetStats() to start over.
+ */
+struct TTimerStats
+{
+  unsigned int fired; ///< Number of triggers
+  unsigned int missed; ///< Number of periods which did not trigger because the loop phase was too slow
+  unsigned int maxLate; ///< Highest lateness of a trigger
+  unsigned int maxRun; ///< Longest execution time of the callback in microseconds
+  unsigned long sumLate; ///< Sum of the lateness of all triggers, mean lateness is sumLate / fired
+  unsigned long sumRun; ///< Sum of the execution times, mean execution time is sumRun / fired
+};
+#endif
 
 /// \cond HIDDEN_FIELD
 
+#define TTIMER_NONE 255
+
+#if defined(TTIMER_DEADLINE_ORDER) || defined(TTIMER_TIMING_WHEEL)
+  #define TTIMER_SCHEDULED
+#endif
+
+#ifdef TTIMER_TIMING_WHEEL
+  #define TTIMER_WHEEL_BITS 4
+  #define TTIMER_WHEEL_SIZE 16
+  #define TTIMER_WHEEL_LEVELS 8
+  #define TTIMER_WHEEL_PENDING (TTIMER_WHEEL_LEVELS * TTIMER_WHEEL_SIZE)
+  #define TTIMER_WHEEL_FIRED (TTIMER_WHEEL_PENDING + 1)
+  #define TTIMER_WHEEL_DUE (TTIMER_WHEEL_PENDING + 2)
+#endif
+
+struct TTIMER_HANDLER
+{
+  TTimerHandler handler;
+  void *context;
+};
+
+struct TTIMER_TIMING
+{
+  byte policy, cap;
+  unsigned int skipped;
+};
+
 struct TTIMER_SLOT
 {
+#ifdef ENABLE_COMPACT_SLOTS
+  uint16_t interval, lastMillis;
+#else
   unsigned long interval, lastMillis;
+#endif
   unsigned int repeat, count;
-  bool active;
+#ifdef TTIMER_DEADLINE_ORDER
+  byte pos, heap; //Position of the slot in the heap and the heap entry stored in this slot
+#elif defined(TTIMER_TIMING_WHEEL)
+  byte next, prev, where;
+#endif
 };
 
 /// \endcond
@@ -76,33 +137,89 @@ private:
 #if TDUINO_TIMER_SIZE > 0
   const byte numTimers = TDUINO_TIMER_SIZE;
   TTIMER_SLOT timers[TDUINO_TIMER_SIZE];
+  byte activeBits[TSLOT_BYTES(TDUINO_TIMER_SIZE)];
 #else
   byte numTimers;
   TTIMER_SLOT* timers;
+  byte *activeBits;
+  bool ownSlots;
 #endif
   
   TTIMER_SLOT* current;
+  TTIMER_HANDLER* handlers;
+  TTIMER_TIMING* timing;
+  TSlotAllocator allocator;
+#ifdef TTIMER_STATS
+  #if TDUINO_TIMER_SIZE > 0
+  TTimerStats stats[TDUINO_TIMER_SIZE];
+  #else
+  TTimerStats* stats;
+  #endif
+#endif
   void (*callback)(byte);
   byte dummy;
   
+#ifdef TTIMER_SCHEDULED
+  void schedule(byte index);
+  void unschedule(byte index);
+#endif
+
+#ifdef TTIMER_DEADLINE_ORDER
+  byte heapSize, fired;
+  void place(byte pos, byte index);
+  void siftUp(byte pos);
+  void siftDown(byte pos);
+#elif defined(TTIMER_TIMING_WHEEL)
+  uint32_t wheelTime;
+  unsigned int wheelMask[TTIMER_WHEEL_LEVELS];
+  byte wheel[TTIMER_WHEEL_DUE + 1];
+  void link(byte index, byte where);
+  bool nextBucket(byte &level, byte &bucket, uint32_t &at);
+#endif
+
+  void init(void(*callback)(byte));
+  void trigger(byte index);
+  void advance(byte index);
+  bool badHandle(TSlotHandle handle, const char* token);
+  
 #ifdef TDUINO_DEBUG
   bool badIndex(byte index, const char* token);
   byte memError;
 #endif
+
+#if TDUINO_TIMER_SIZE == 0
+protected:
+
+  /**
+   * \brief Constructs a timer instance using external memory for the slots.
+   * \param callback The callback used by this instance.
+   * \param slots The memory used for the slots (must live as long as the timer).
+   * \param activeBits The memory used for the active flags, TSLOT_BYTES(numTimers) bytes.
+   * \param numTimers The number of slots in _slots_.
+   * 
+   * Used by TTimerN in order to keep the slots inside the object.
+   */
+  TTimer(void(*callback)(byte), TTIMER_SLOT *slots, byte *activeBits, byte numTimers);
+#endif
   
 public:
 
   /**
    * \brief Constructs a timer instance.
-   * \param callback The callback used by this instance.
+   * \param callback The callback used by this instance (may be NULL if all slots use setHandler()).
    * \param numTimers The number of timer slots to create.
    * 
    * Constructs an instance of the TTimer with a predefined number of timer slots and a
 	* callback to be invoked whenever a timer slot is triggered.
    * 
-   * _numTimers_ must be in the range 1..255, memory usage (in bytes) is: (13 * numTimers) + 2.
+   * _numTimers_ must be in the range 1..255, memory usage (in bytes) is: (12 * numTimers) + 2
+   * plus one bit per slot.
+   * If TTIMER_DEADLINE_ORDER is defined, each timer slot uses two additional bytes. If
+   * TTIMER_TIMING_WHEEL is defined, each timer slot uses three additional bytes and the
+   * wheel itself uses 151 bytes per instance of TTimer (167 on 32 bit boards). If ENABLE_COMPACT_SLOTS is
+   * defined, each timer slot uses 8 bytes plus one bit.
    * 
-   * \ref static_allocation
+   * \ref static_allocation \ref tduino_tweaks
    */
   TTimer(void(*callback)(byte), byte numTimers = 1);
   
@@ -154,6 +271,54 @@ public:
 	*/
   unsigned long getInterval(byte index = 0);
 
+  /**
+   * \brief Get the number of periods skipped by a timer slot.
+   * \param index The index of a timer slot.
+   * 
+   * When the loop phase of the sketch has been too slow for a timer slot, the periods
+   * which were not triggered are added to this number. Using #TDUINO_TIMING_BEST_EFFORT
+   * the missed periods are coalesced into one trigger and using #TDUINO_TIMING_CAPPED
+   * the periods beyond the limit are skipped. Skipped periods are not counted by
+   * getCounter(). The number is reset by set() and restart() and it rolls over at 65535.
+   * 
+   * \returns The number of skipped periods or 0 if setTiming() has not been used.
+   * 
+   * \see setTiming()
+   */
+  unsigned int getSkipped(byte index = 0);
+  
+#ifdef TTIMER_STATS
+  /**
+   * \brief Get the statistics of a timer slot.
+   * \param index The index of a timer slot.
+   * 
+   * Only available if TTIMER_STATS is defined (see \ref tduino_tweaks). The statistics
+   * tells how late a slot is triggered and how long its callback takes, which is useful
+   * in order to find out which parts of a sketch are overrunning the loop phase:
+   * 
+   * \code
+   * TTimerStats s = timer.getStats(0);
+   * if (s.fired > 0)
+   * {
+   *   Serial.print(s.sumLate / s.fired); //Mean lateness
+   *   Serial.print(s.maxRun);            //Longest callback
+   * }
+   * \endcode
+   * 
+   * \returns A copy of the statistics.
+   * 
+   * \see resetStats()
+   */
+  TTimerStats getStats(byte index = 0);
+  
+  /**
+   * \brief Reset the statistics of all timer slots.
+   * 
+   * Only available if TTIMER_STATS is defined.
+   */
+  void resetStats();
+#endif
+  
   /**
    * \brief Get number of timer slots. 
    * \return The number of timer slots.
@@ -227,6 +392,8 @@ public:
 	* repetitions has been triggered, the slot is deactivated. If repetitions
 	* is set to 0 (the default), the slot will be triggered indefinately. The
    * first trigger will happen after _interval_ has elapsed.
+   * 
+   * If ENABLE_COMPACT_SLOTS is defined, _interval_ cannot exceed 65535.
    */
   void set(byte index, unsigned long interval, unsigned int repetitions);
   
@@ -236,6 +403,130 @@ public:
   */
   void set(unsigned long interval, unsigned int repetitions);
   
+  /**
+   * \brief Set a handler for a timer slot.
+   * \param index The index of the slot.
+   * \param handler The handler or NULL to use the callback of the timer.
+   * \param context Passed as the first argument to the handler.
+   * 
+   * When a slot has a handler, the handler is invoked rather than the callback given to
+   * the constructor. Since each slot can have its own handler and context, one timer
+   * can serve several independent parts of a sketch without a chain of "if (index == ...)"
+   * in the callback. Use TDuino_Method to call a method of an object:
+   * 
+   * \code
+   * void blink(void *context, byte index)
+   * {
+   *   ((TPin*)context)->flip();
+   * }
+   * 
+   * timer.setHandler(0, blink, &led1);
+   * timer.setHandler(1, blink, &led2);
+   * timer.setHandler(2, TDuino_Method<TDisplay, &TDisplay::refresh>, &display);
+   * \endcode
+   * 
+   * The first call allocates the handlers for all slots (4 bytes per slot, 8 or 16 on
+   * 32 / 64 bit boards).
+   * 
+   * \see TDuino_Method
+   */
+  void setHandler(byte index, TTimerHandler handler, void *context = NULL);
+  
+  /**
+   * \brief Set the timing policy of a timer slot.
+   * \param index The index of the slot.
+   * \param policy #TDUINO_TIMING_BEST_EFFORT, #TDUINO_TIMING_TIGHT or #TDUINO_TIMING_CAPPED.
+   * \param cap The number of missed periods to catch up when using #TDUINO_TIMING_CAPPED.
+   * 
+   * By default all slots use the timing selected with ENABLE_TIGHT_TIMING (see
+   * \ref tduino_tweaks), setTiming() allows each slot to use its own timing:
+   * 
+   * - #TDUINO_TIMING_BEST_EFFORT: The next period starts when the slot is triggered, so
+   *   the interval will drift if the loop phase is slow and missed periods are lost.
+   * - #TDUINO_TIMING_TIGHT: The next period starts when the previous period ended, so the
+   *   slot does not drift but after a stall of the loop phase it will trigger once per
+   *   loop until all the missed periods have been caught up.
+   * - #TDUINO_TIMING_CAPPED: Same as tight timing, but if the slot is more than _cap_
+   *   periods behind, the periods beyond _cap_ are skipped and the slot stays in phase.
+   *   Using a _cap_ of zero, the slot triggers once after a stall.
+   * 
+   * \code
+   * timer.setTiming(0, TDUINO_TIMING_TIGHT);     //Clock, must not drift
+   * timer.setTiming(1, TDUINO_TIMING_CAPPED, 2); //Sampling, at most 2 late samples
+   * \endcode
+   * 
+   * The first call allocates the timing for all slots (4 bytes per slot).
+   * 
+   * \see getSkipped()
+   */
+  void setTiming(byte index, byte policy, byte cap = 0);
+  
+  /**
+   * \brief Allocate a free timer slot.
+   * \return A handle to the slot, the index of the handle is #TSLOT_NONE if no slot is free.
+   * 
+   * Rather than finding a free slot with firstInactive() and using its index, a slot
+   * can be allocated and used with a handle. Allocating and releasing a slot takes the
+   * same (short) time regardless of the number of slots, and a handle becomes invalid
+   * when the slot is released, so an old handle can never change a slot which has been
+   * allocated by someone else:
+   * 
+   * \code
+   * TSlotHandle blink = timer.allocate();
+   * timer.set(blink, 500, 10);
+   * ...
+   * timer.release(blink); //Stops the slot, "blink" can no longer be used
+   * timer.stop(blink);    //Ignored
+   * \endcode
+   * 
+   * The slots which are active when allocate() is called for the first time are never
+   * allocated, so slots used by index should be set before allocating any slots. The
+   * first call allocates 3 bytes per slot (4 bytes on 32 bit boards).
+   * 
+   * \see release() isValid()
+   */
+  TSlotHandle allocate();
+  
+  /**
+   * \brief Release a slot allocated with allocate().
+   * \param handle The handle of the slot.
+   * \return False if the handle is not valid.
+   * 
+   * The slot is stopped, its handler (if any) is cleared and the slot is returned to
+   * the free slots.
+   */
+  bool release(TSlotHandle handle);
+  
+  /**
+   * \brief Check if a handle is valid.
+   * \param handle The handle to check.
+   * \return True if the slot of the handle has not been released.
+   */
+  bool isValid(TSlotHandle handle);
+  
+  /**
+   * \brief Same as set(byte index, unsigned long interval, unsigned int repetitions) using a handle.
+   * 
+   * Nothing is done if the handle is not valid.
+   */
+  void set(TSlotHandle handle, unsigned long interval, unsigned int repetitions);
+  
+  /**
+   * \brief Same as isActive(byte index) using a handle.
+   * \return False if the handle is not valid.
+   */
+  bool isActive(TSlotHandle handle);
+  
+  /**
+   * \brief Same as restart(byte index) using a handle.
+   */
+  void restart(TSlotHandle handle);
+  
+  /**
+   * \brief Same as stop(byte index) using a handle.
+   */
+  void stop(TSlotHandle handle);
+  
   /**
    * \brief Stop a timer slot.
    * \param index The index of the slot to stop.
@@ -257,13 +548,65 @@ public:
    */
   void stopAll();
 
+  /**
+   * \brief Get the time until the next timer slot triggers.
+   * 
+   * Returns the time until the first active timer slot is due or TDUINO_NOT_DUE if
+   * no slots are active. When using TTIMER_TIMING_WHEEL, the returned value may be
+   * lower than the actual time until a slot is due.
+   * 
+   * \see TBase::nextDueIn()
+   */
+  virtual unsigned long nextDueIn();
+
   /**
 	* \brief The timer's loop phase.
 	* 
-	* Must be called to ensure that the timer slots are working as intended.
+	* Must be called to ensure that the timer slots are working as intended. Only the active
+	* slots are examined, inactive slots are skipped using a bitmap.
+	* 
+	* If TTIMER_DEADLINE_ORDER or TTIMER_TIMING_WHEEL is defined, only the slots which
+	* are due will be examined, see \ref tduino_tweaks.
 	*/
   virtual void loop();
 
 };
 
+#if TDUINO_TIMER_SIZE == 0
+/**
+ * \brief A TTimer with a fixed number of slots.
+ * 
+ * TTimerN is a TTimer where the number of slots is given at compile time and the
+ * slots are stored inside the object rather than in dynamic memory. Unlike
+ * TDUINO_TIMER_SIZE (see \ref static_allocation) each instance can have its own
+ * number of slots:
+ * 
+ * \code
+ * TTimerN<2> blinkTimer(blinkCallback);   //2 slots
+ * TTimerN<12> sensorTimer(sensorCallback); //12 slots
+ * \endcode
+ * 
+ * Only the slots (and their active flags) are kept inside the object. The features which
+ * are allocated on first use still use dynamic memory: setHandler(), setTiming() and
+ * allocate() allocate their per slot data the first time they are called, and the
+ * statistics are allocated by the constructor when TTIMER_STATS is defined.
+ * 
+ * TTimerN is not available when TDUINO_TIMER_SIZE is defined.
+ */
+template <byte SLOTS> class TTimerN : public TTimer
+{
+private:
+  TTIMER_SLOT storage[SLOTS];
+  byte activeStorage[TSLOT_BYTES(SLOTS)];
+
+public:
+
+  /**
+   * \brief Constructs a timer instance with _SLOTS_ slots.
+   * \param callback The callback used by this instance.
+   */
+  TTimerN(void(*callback)(byte)) : TTimer(callback, storage, activeStorage, SLOTS) {}
+};
+#endif
+
 #endif //TTIMER_H
@@ -0,0 +1,68 @@
+//Required hardware: 4 push buttons, 4 1K Ohm resistors
+
+//Required wiring:
+//Pin D4 => 1K Ohm resistor => button 1 leg 1
+//Pin D5 => 1K Ohm resistor => button 2 leg 1
+//Pin D6 => 1K Ohm resistor => button 3 leg 1
+//Pin D7 => 1K Ohm resistor => button 4 leg 1
+//GND => leg 2 of all buttons
+
+//The sketch can also be compiled for the host (see extras/host), in
+//which case bouncy buttons are simulated and the events are printed.
+
+#include <TDuino.h>
+
+const byte BUTTON_PINS[] = { 4, 5, 6, 7 };
+
+TButtonBank buttons;
+
+void buttonPress(byte buttonPin, int state)
+{
+  Serial.print(F("Press "));
+  Serial.print(buttonPin);
+  Serial.print(F(" at "));
+  Serial.println(millis());
+}
+
+void buttonRelease(byte buttonPin, int state)
+{
+  Serial.print(F("Release "));
+  Serial.print(buttonPin);
+  Serial.print(F(" at "));
+  Serial.println(millis());
+}
+
+void setup()
+{
+  Serial.begin(9600);
+  
+  //Attach all the buttons at once
+  buttons.attach(BUTTON_PINS, sizeof(BUTTON_PINS));
+  
+  buttons.onPress(buttonPress);
+  buttons.onRelease(buttonRelease);
+  
+  //Repeat the last pressed button after half a second and then 5 times per second
+  buttons.setRepeat(500, 200);
+  
+#ifdef TDUINO_HOST
+  //Button 1 is pressed with contact bounce and held for a while
+  TDuinoHost::scheduleInput(4, LOW, 1000);
+  TDuinoHost::scheduleInput(4, HIGH, 1002);
+  TDuinoHost::scheduleInput(4, LOW, 1004);
+  TDuinoHost::scheduleInput(4, HIGH, 2000);
+  //Button 3 has a short spike which is ignored
+  TDuinoHost::scheduleInput(6, LOW, 1200);
+  TDuinoHost::scheduleInput(6, HIGH, 1208);
+  //Button 2 and 4 are pressed at the same time
+  TDuinoHost::scheduleInput(5, LOW, 2500);
+  TDuinoHost::scheduleInput(7, LOW, 2500);
+  TDuinoHost::scheduleInput(5, HIGH, 2600);
+  TDuinoHost::scheduleInput(7, HIGH, 2600);
+#endif
+}
+
+void loop()
+{
+  buttons.loop();
+}
@@ -0,0 +1,77 @@
+//Required hardware: Push button, 1K Ohm resistor
+
+//Required wiring:
+//Pin D4 => 1K Ohm resistor => button leg 1
+//GND => button leg 2
+
+//The sketch can also be compiled for the host (see extras/host), in
+//which case a series of gestures is simulated and printed.
+
+#include <TDuino.h>
+
+#define BUTTON_PIN 4
+
+TPin led;
+TButton button;
+
+void buttonClick(byte buttonPin, byte clicks)
+{
+  Serial.print(clicks);
+  Serial.print(F(" click(s) at "));
+  Serial.println(millis());
+  
+  //Single click turns the LED on, double click turns it off
+  if (clicks == 1) led.on();
+  else if (clicks == 2) led.off();
+}
+
+void buttonLongPress(byte buttonPin, int state)
+{
+  Serial.print(F("Long press at "));
+  Serial.println(millis());
+  led.flip();
+}
+
+#ifdef TDUINO_HOST
+void simulatePress(unsigned long at, unsigned long duration)
+{
+  TDuinoHost::scheduleInput(BUTTON_PIN, LOW, at);
+  TDuinoHost::scheduleInput(BUTTON_PIN, HIGH, at + duration);
+}
+#endif
+
+void setup()
+{
+  Serial.begin(9600);
+  
+  //Attach button to pin
+  button.attach(BUTTON_PIN);
+  
+  //Set the gesture callbacks
+  button.onClick(buttonClick);
+  button.onLongPress(buttonLongPress);
+  
+  //Clicks must follow each other within 300 milliseconds and a
+  //press becomes a long press after one second
+  button.setClick(300, 1000);
+  
+  led.attach(LED_BUILTIN, OUTPUT);
+  led.off();
+  
+#ifdef TDUINO_HOST
+  simulatePress(1000, 100); //Single click
+  simulatePress(2000, 100); //Double click
+  simulatePress(2200, 100);
+  simulatePress(3000, 80);  //Triple click
+  simulatePress(3200, 80);
+  simulatePress(3400, 80);
+  simulatePress(4000, 1500); //Long press
+  simulatePress(6000, 100); //Click followed by a long press
+  simulatePress(6200, 1200);
+#endif
+}
+
+void loop()
+{
+  button.loop();
+}
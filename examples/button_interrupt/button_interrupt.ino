@@ -0,0 +1,85 @@
+//Required hardware: Push button, 1K Ohm resistor
+
+//Required wiring:
+//Pin D2 => 1K Ohm resistor => button leg 1
+//GND => button leg 2
+
+//Pin D2 (or D3 on an UNO) must be used, since the button needs a pin
+//which supports interrupts. ENABLE_PIN_INTERRUPTS must be uncommented in
+//TDefs.h (or passed to the compiler when running on a host computer).
+
+//The sketch can also be compiled for the host (see extras/host), in
+//which case a bouncy button is simulated and the events are printed.
+
+#include <TDuino.h>
+
+#ifndef ENABLE_PIN_INTERRUPTS
+
+void setup()
+{
+  Serial.begin(9600);
+  Serial.println(F("Please uncomment ENABLE_PIN_INTERRUPTS in TDefs.h"));
+}
+
+void loop()
+{
+}
+
+#else
+
+#define BUTTON_PIN 2
+
+TPin led;
+TButton button;
+
+void buttonPress(byte buttonPin, int state)
+{
+  led.on();
+  Serial.print(F("Press at "));
+  Serial.println(millis());
+}
+
+void buttonRelease(byte buttonPin, int state)
+{
+  led.off();
+  Serial.print(F("Release at "));
+  Serial.println(millis());
+}
+
+void setup()
+{
+  Serial.begin(9600);
+  
+  led.attach(LED_BUILTIN);
+  
+  //Attach button to pin
+  button.attach(BUTTON_PIN);
+  
+  //Let an interrupt capture the edges on the pin. The edges are timestamped
+  //by the interrupt, so even if loop() is delayed by other work the debounce
+  //is measured from the time of the actual edge.
+  if (!button.setInterrupt(true)) Serial.println(F("Pin does not support interrupts"));
+  
+  button.onPress(buttonPress);
+  button.onRelease(buttonRelease);
+  
+#ifdef TDUINO_HOST
+  //Press with contact bounce at 1000 ms, release with bounce at 1500 ms
+  TDuinoHost::scheduleInput(BUTTON_PIN, LOW, 1000);
+  TDuinoHost::scheduleInput(BUTTON_PIN, HIGH, 1001);
+  TDuinoHost::scheduleInput(BUTTON_PIN, LOW, 1002);
+  TDuinoHost::scheduleInput(BUTTON_PIN, HIGH, 1500);
+  TDuinoHost::scheduleInput(BUTTON_PIN, LOW, 1503);
+  TDuinoHost::scheduleInput(BUTTON_PIN, HIGH, 1505);
+#endif
+}
+
+void loop()
+{
+  button.loop();
+  
+  //Simulate a busy loop, the edges are captured by the interrupt meanwhile
+  delay(7);
+}
+
+#endif //ENABLE_PIN_INTERRUPTS
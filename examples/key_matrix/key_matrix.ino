@@ -0,0 +1,99 @@
+//Required hardware: 4x4 keypad (membrane keypad or 16 push buttons)
+
+//Required wiring:
+//Pin D2 .. D5 => Row 1 .. 4 of the keypad
+//Pin D6 .. D9 => Column 1 .. 4 of the keypad
+
+//The sketch can also be compiled for the host (see extras/host), in
+//which case the keypad is emulated with TDuinoHost::onPinMode() and
+//a few key presses (including a ghost key) are simulated.
+
+#include <TDuino.h>
+
+const byte ROW_PINS[] = { 2, 3, 4, 5 };
+const byte COLUMN_PINS[] = { 6, 7, 8, 9 };
+const char KEYS[] = "123A456B789C*0#D";
+
+TKeyMatrix keypad;
+
+void keyPress(byte key, int state)
+{
+  Serial.print(F("Press "));
+  Serial.print(KEYS[key]);
+  Serial.print(F(" at "));
+  Serial.println(millis());
+}
+
+void keyRelease(byte key, int state)
+{
+  Serial.print(F("Release "));
+  Serial.print(KEYS[key]);
+  Serial.print(F(" at "));
+  Serial.println(millis());
+}
+
+#ifdef TDUINO_HOST
+
+//The keys which are held down, one bit for each key
+unsigned int keysDown = 0;
+
+//Emulates the wiring of the keypad: the columns which are connected to the driven row
+//through the keys held down are pulled LOW. Since the keypad has no diodes, the current
+//may also flow through the other rows, which is what causes ghost keys.
+void keypadPinMode(byte pin, byte mode)
+{
+  byte lowRows = 0, lowCols = 0, prev;
+  for (byte r = 0; r < 4; r++) if (TDuinoHost::getMode(ROW_PINS[r]) == OUTPUT) lowRows |= 1 << r;
+  do
+  {
+    prev = lowCols;
+    for (byte k = 0; k < 16; k++)
+    {
+      if (!((keysDown >> k) & 1)) continue;
+      if ((lowRows >> (k / 4)) & 1) lowCols |= 1 << (k % 4);
+      if ((lowCols >> (k % 4)) & 1) lowRows |= 1 << (k / 4);
+    }
+  } while (prev != lowCols);
+  for (byte c = 0; c < 4; c++) TDuinoHost::setInput(COLUMN_PINS[c], ((lowCols >> c) & 1) ? LOW : HIGH);
+}
+
+struct KeyEvent { unsigned long ms; char key; bool down; };
+const KeyEvent SCRIPT[] = {
+  { 1000, '5', true }, { 1200, '5', false },                       //Single key
+  { 2000, '1', true }, { 2100, '2', true }, { 2200, '4', true },  //'5' becomes a ghost
+  { 2500, '1', false }, { 2500, '2', false }, { 2500, '4', false },
+  { 3000, '*', true }, { 3050, 'D', true }, { 3300, '*', false }, { 3300, 'D', false } //Rollover
+};
+byte scriptIndex = 0;
+
+void runScript()
+{
+  while ((scriptIndex < sizeof(SCRIPT) / sizeof(KeyEvent)) && (millis() >= SCRIPT[scriptIndex].ms))
+  {
+    byte k = strchr(KEYS, SCRIPT[scriptIndex].key) - KEYS;
+    if (SCRIPT[scriptIndex].down) keysDown |= 1 << k;
+    else keysDown &= ~(1 << k);
+    scriptIndex++;
+  }
+}
+
+#endif
+
+void setup()
+{
+  Serial.begin(9600);
+#ifdef TDUINO_HOST
+  TDuinoHost::onPinMode(keypadPinMode);
+#endif
+  keypad.attach(ROW_PINS, 4, COLUMN_PINS, 4);
+  keypad.onPress(keyPress);
+  keypad.onRelease(keyRelease);
+}
+
+void loop()
+{
+#ifdef TDUINO_HOST
+  runScript();
+#endif
+  keypad.loop();
+}
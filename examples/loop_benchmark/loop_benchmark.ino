@@ -0,0 +1,224 @@
+//Required hardware: A board with plenty of memory (eg. Mega, Due, ESP8266 / ESP32)
+//Required wiring: Connect pin 5 to GND in order to keep the button pressed
+
+//Measures the average time spent in loop() for each of the classes in TDuino. The
+//result of each case is printed to serial as a comma separated line:
+//
+//  variant,case,param,ticks,ns_per_tick,events
+//
+//"variant" lists the timing related tweaks enabled in TDefs.h (ENABLE_TIGHT_TIMING,
+//TIMING_WITH_MICROS and TPININPUT_FLOAT_MATH), run the sketch once for each combination
+//you want to compare. The sketch can also be run on a computer using the shim found in
+//extras/host of the library folder, eg:
+//
+//  g++ -O2 -DARDUINO=100 -DENABLE_TIGHT_TIMING -Iextras/host -I. -x c++ examples/loop_benchmark/loop_benchmark.ino -x none *.cpp extras/host/TDuinoHost.cpp -o loop_benchmark
+//  ./loop_benchmark -r 1
+//
+//The CMake build in extras/host builds the sketch for each of the variants and runs them
+//with "ctest -L benchmark -V".
+
+#include <TDuino.h>
+
+#ifdef TDUINO_HOST
+  #define TICKS 200000UL //Host timing resolution is one microsecond
+#else
+  #define TICKS 2000UL
+#endif
+
+#define INPUT_PIN A0
+#define BUTTON_PIN 5
+#define OUTPUT_PIN 3
+
+const byte TIMER_SLOTS[] = { 1, 16, 64, 255 };
+const byte TIMELINE_SLOTS[] = { 1, 8 };
+const byte BANK_PINS[] = { 5, 2, 4, 6, 7, 8, 9, 10, 11, 12, 13, 15, 16, 17, 18, 19 };
+
+unsigned long events = 0;
+
+void timerCallback(byte index) { events++; }
+void timelineCallback(byte index, float progress) { events++; }
+void timelineFixedCallback(byte index, unsigned int progress) { events++; }
+void timelineByteCallback(byte index, byte value) { events++; }
+void timelineIntCallback(byte index, int value) { events++; }
+void timelineLongCallback(byte index, long value) { events++; }
+void pinCallback(byte pin, int state) { events++; }
+
+void printVariant()
+{
+  bool any = false;
+#ifdef ENABLE_TIGHT_TIMING
+  Serial.print(F("tight"));
+  any = true;
+#endif
+#ifdef TIMING_WITH_MICROS
+  if (any) Serial.print(F("+"));
+  Serial.print(F("micros"));
+  any = true;
+#endif
+#ifdef TPININPUT_FLOAT_MATH
+  if (any) Serial.print(F("+"));
+  Serial.print(F("float"));
+  any = true;
+#endif
+  if (!any) Serial.print(F("default"));
+}
+
+//Calls loop() of the object TICKS times and prints the result (TButton is not a TBase
+//to the sketch, so a macro is used rather than a function taking a TBase*)
+#define BENCHMARK(name, param, object) { \
+  (object).loop(); \
+  events = 0; \
+  unsigned long start = micros(); \
+  for (unsigned long i = 0; i < TICKS; i++) (object).loop(); \
+  report(F(name), param, micros() - start); \
+}
+
+void report(const __FlashStringHelper *name, unsigned int param, unsigned long elapsed)
+{
+  printVariant();
+  Serial.print(F(","));
+  Serial.print(name);
+  Serial.print(F(","));
+  Serial.print(param);
+  Serial.print(F(","));
+  Serial.print(TICKS);
+  Serial.print(F(","));
+  Serial.print((elapsed * 1000.0f) / TICKS);
+  Serial.print(F(","));
+  Serial.println(events);
+}
+
+void benchmarkTimers()
+{
+  for (byte i = 0; i < sizeof(TIMER_SLOTS); i++)
+  {
+    TTimer *timer = new TTimer(timerCallback, TIMER_SLOTS[i]);
+    
+    //Idle: Nothing will trigger during the benchmark
+    for (byte s = 0; s < timer->getSize(); s++) timer->set(s, 3600000UL, 0);
+    BENCHMARK("timer_idle", TIMER_SLOTS[i], *timer);
+    
+    //Busy: Every slot triggers on every tick
+    for (byte s = 0; s < timer->getSize(); s++) timer->set(s, 0, 0);
+    BENCHMARK("timer_busy", TIMER_SLOTS[i], *timer);
+    
+    delete timer;
+  }
+}
+
+void benchmarkTimelines()
+{
+  for (byte i = 0; i < sizeof(TIMELINE_SLOTS); i++)
+  {
+    TTimeline *timeline = new TTimeline(timelineCallback, TIMELINE_SLOTS[i]);
+    for (byte s = 0; s < timeline->getSize(); s++) timeline->set(s, 3600000UL);
+    BENCHMARK("timeline", TIMELINE_SLOTS[i], *timeline);
+    delete timeline;
+    
+    timeline = new TTimeline(timelineFixedCallback, TIMELINE_SLOTS[i]);
+    for (byte s = 0; s < timeline->getSize(); s++) timeline->set(s, 3600000UL);
+    BENCHMARK("timeline_fixed", TIMELINE_SLOTS[i], *timeline);
+    delete timeline;
+    
+    TTimelineT<byte> *timelineByte = new TTimelineT<byte>(timelineByteCallback, TIMELINE_SLOTS[i]);
+    timelineByte->setMinMax(0, 255);
+    for (byte s = 0; s < timelineByte->getSize(); s++) timelineByte->set(s, 3600000UL);
+    BENCHMARK("timelinet_byte", TIMELINE_SLOTS[i], *timelineByte);
+    delete timelineByte;
+    
+    TTimelineT<int> *timelineInt = new TTimelineT<int>(timelineIntCallback, TIMELINE_SLOTS[i]);
+    timelineInt->setMinMax(-1000, 1000);
+    for (byte s = 0; s < timelineInt->getSize(); s++) timelineInt->set(s, 3600000UL);
+    BENCHMARK("timelinet_int", TIMELINE_SLOTS[i], *timelineInt);
+    delete timelineInt;
+    
+    TTimelineT<long> *timelineLong = new TTimelineT<long>(timelineLongCallback, TIMELINE_SLOTS[i]);
+    timelineLong->setMinMax(-100000L, 100000L);
+    for (byte s = 0; s < timelineLong->getSize(); s++) timelineLong->set(s, 3600000UL);
+    BENCHMARK("timelinet_long", TIMELINE_SLOTS[i], *timelineLong);
+    delete timelineLong;
+  }
+}
+
+void benchmarkInputs()
+{
+  TPinInput input;
+  input.attach(INPUT_PIN);
+  input.onRising(pinCallback);
+  input.onFalling(pinCallback);
+  BENCHMARK("input_unbuffered", 1, input);
+  input.setSamples(10, true);
+  BENCHMARK("input_buffered", 10, input);
+  input.setSamples(10, false);
+  BENCHMARK("input_sampled", 10, input);
+}
+
+void benchmarkOutputs()
+{
+  TPinOutput output;
+  output.attach(OUTPUT_PIN);
+  output.pulse(1);
+  BENCHMARK("output_pulse", 1, output);
+  output.oscillate(1000);
+  BENCHMARK("output_oscillate", 1000, output);
+}
+
+void benchmarkButton()
+{
+  TButton button;
+#ifdef TDUINO_HOST
+  TDuinoHost::setInput(BUTTON_PIN, LOW);
+#endif
+  button.attach(BUTTON_PIN);
+  button.onPress(pinCallback);
+  button.setRepeat(10, 1);
+  BENCHMARK("button_repeat", 1, button);
+}
+
+//A number of TButton's looped one by one, compared to a TButtonBank below. An idle TButton
+//reads its pin in every loop() while the bank only reads the pins each time a quarter of
+//the debounce has elapsed, so "button_bank" mostly measures the loops without a read and the
+//two cases are not a comparison of the cost per read. The cost of reading the pins one by
+//one and as a group is measured by the example "pin_group_benchmark".
+struct ButtonArray
+{
+  TButton buttons[sizeof(BANK_PINS)];
+  byte count;
+  void loop() { for (byte i = 0; i < count; i++) buttons[i].loop(); }
+};
+
+void benchmarkButtonBank()
+{
+  ButtonArray *array = new ButtonArray;
+  array->count = sizeof(BANK_PINS);
+  for (byte i = 0; i < array->count; i++)
+  {
+    array->buttons[i].attach(BANK_PINS[i]);
+    array->buttons[i].onPress(pinCallback);
+  }
+  BENCHMARK("button_array", sizeof(BANK_PINS), *array);
+  delete array;
+  
+  TButtonBank bank;
+  bank.onPress(pinCallback);
+  bank.attach(BANK_PINS, 1);
+  BENCHMARK("button_bank", 1, bank);
+  bank.attach(BANK_PINS, sizeof(BANK_PINS));
+  BENCHMARK("button_bank", sizeof(BANK_PINS), bank);
+}
+
+void setup()
+{
+  Serial.begin(115200);
+  Serial.println(F("variant,case,param,ticks,ns_per_tick,events"));
+  benchmarkTimers();
+  benchmarkTimelines();
+  benchmarkInputs();
+  benchmarkOutputs();
+  benchmarkButton();
+  benchmarkButtonBank();
+}
+
+void loop()
+{
+}
@@ -0,0 +1,84 @@
+//Required hardware: Any board (the pins 2-17 are used as outputs, nothing should be connected)
+
+//Measures the average time it takes to write and read a pattern to / from 8 and 16 pins
+//using TPinGroup compared to using a TPin for each pin. Run the sketch with and without
+//ENABLE_DIRECT_PORT_IO defined in TDefs.h in order to see the effect of grouping the pins
+//by port. Each result is printed to serial as a comma separated line:
+//
+//  method,pins,operations,ns_per_operation
+//
+//The sketch can also be run on a computer using the shim found in extras/host of the
+//library folder, see "loop_benchmark" for details. Please note that the mocked port
+//registers of the host are much slower than real registers, so on the host the numbers
+//from builds with ENABLE_DIRECT_PORT_IO only tells how many port accesses are saved.
+
+#include <TDuino.h>
+
+#ifdef TDUINO_HOST
+  #define OPERATIONS 100000UL //Host timing resolution is one microsecond
+#else
+  #define OPERATIONS 1000UL
+#endif
+
+const byte PINS[] = { 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15, 16, 17 };
+const byte PIN_COUNTS[] = { 8, 16 };
+
+TPin pins[sizeof(PINS)];
+TPinGroup group;
+unsigned long checksum = 0; //Prevents the reads from being optimized away
+
+void report(const __FlashStringHelper *method, byte count, unsigned long elapsed)
+{
+  Serial.print(method);
+  Serial.print(F(","));
+  Serial.print(count);
+  Serial.print(F(","));
+  Serial.print(OPERATIONS);
+  Serial.print(F(","));
+  Serial.println((elapsed * 1000.0f) / OPERATIONS);
+}
+
+void benchmark(byte count)
+{
+  unsigned long start, i, pattern;
+  byte p;
+  
+  group.attach(PINS, count);
+  
+  start = micros();
+  for (i = 0; i < OPERATIONS; i++)
+  {
+    pattern = i * 0x9E3779B1UL;
+    for (p = 0; p < count; p++) pins[p].enable((pattern >> p) & 1);
+  }
+  report(F("tpin_write"), count, micros() - start);
+  
+  start = micros();
+  for (i = 0; i < OPERATIONS; i++) group.write(i * 0x9E3779B1UL);
+  report(F("group_write"), count, micros() - start);
+  
+  start = micros();
+  for (i = 0; i < OPERATIONS; i++)
+  {
+    pattern = 0;
+    for (p = 0; p < count; p++) if (pins[p].state()) pattern |= 1UL << p;
+    checksum += pattern;
+  }
+  report(F("tpin_read"), count, micros() - start);
+  
+  start = micros();
+  for (i = 0; i < OPERATIONS; i++) checksum += group.read();
+  report(F("group_read"), count, micros() - start);
+}
+
+void setup()
+{
+  Serial.begin(115200);
+  for (byte i = 0; i < sizeof(PINS); i++) pins[i].attach(PINS[i], OUTPUT);
+  Serial.println(F("method,pins,operations,ns_per_operation"));
+  for (byte i = 0; i < sizeof(PIN_COUNTS); i++) benchmark(PIN_COUNTS[i]);
+}
+
+void loop()
+{
+}
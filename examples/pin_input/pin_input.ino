@@ -14,6 +14,7 @@
 
 TPinOutput led;
 TPinInput pot;
+//TFilterEMA potFilter(3);
 
 void potCallback(byte pin, int state)
 {
@@ -44,6 +45,11 @@ void setup()
   //If you only wanted values which deviate with at least 5 from
   //the previous reading, you could:
   //pot.setDeviation(5);
+  
+  //If you wanted to smooth the readings of the pot without using
+  //a sample buffer, you could use a filter (uncomment potFilter and
+  //ENABLE_PIN_FILTERS in TDefs.h):
+  //pot.setFilter(&potFilter);
 }
 
 void loop()
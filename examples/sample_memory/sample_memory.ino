@@ -0,0 +1,50 @@
+//Required hardware: Any board
+
+//Prints the amount of memory used for averaging the samples of a TPinInput, comparing
+//the buffer allocated by TPinInput::setSamples(samples, true) with TFilterAverageT and
+//TFilterEMA. Each result is printed to serial as a comma separated line:
+//
+//  method,samples,bytes,heap
+//
+//The dynamic memory used by setSamples() includes the bookkeeping of malloc (assumed
+//to be the size of size_t, which is true for AVR boards). The numbers depend on the board:
+//on an AVR board 16 samples uses 34 bytes with setSamples(), 39 bytes with int or uint16_t
+//storage (not on the heap, but not less either), 23 bytes with byte storage and 27 bytes
+//with TFilterPacked10. On a computer pointers and int are larger, so the numbers printed
+//by the shim found in extras/host of the library folder (see "loop_benchmark" for details)
+//are not the numbers of a board.
+
+#include <TDuino.h>
+
+void report(const __FlashStringHelper *method, byte samples, unsigned int bytes, bool heap)
+{
+  Serial.print(method);
+  Serial.print(F(","));
+  Serial.print(samples);
+  Serial.print(F(","));
+  Serial.print(bytes);
+  Serial.print(F(","));
+  Serial.println(heap ? F("yes") : F("no"));
+}
+
+#define REPORT(N) \
+  report(F("setSamples"), N, N * sizeof(int) + sizeof(size_t), true); \
+  report(F("TFilterAverageT<int>"), N, sizeof(TFilterAverageT<N, int>), false); \
+  report(F("TFilterAverageT<uint16_t>"), N, sizeof(TFilterAverageT<N, uint16_t>), false); \
+  report(F("TFilterAverageT<byte>"), N, sizeof(TFilterAverageT<N, byte>), false); \
+  report(F("TFilterAverageT<TFilterPacked10>"), N, sizeof(TFilterAverageT<N, TFilterPacked10>), false)
+
+void setup()
+{
+  Serial.begin(9600);
+  Serial.println(F("method,samples,bytes,heap"));
+  REPORT(8);
+  REPORT(16);
+  REPORT(32);
+  report(F("TFilterEMA"), 0, sizeof(TFilterEMA), false);
+  report(F("TFilterMedian"), TFILTER_MEDIAN_MAX, sizeof(TFilterMedian), false);
+}
+
+void loop()
+{
+}
@@ -0,0 +1,97 @@
+//Required hardware: A board with plenty of memory (eg. Mega, Due, ESP8266 / ESP32)
+
+//Compares the memory used per slot and the time spent in loop() for TTimer and TTimeline
+//with and without ENABLE_COMPACT_SLOTS. Run the sketch once with the default slots and
+//once with ENABLE_COMPACT_SLOTS uncommented in TDefs.h in order to compare them. Each
+//result is printed to serial as a comma separated line:
+//
+//  layout,object,slots,active,bytes_per_slot,nanoseconds_per_loop,events
+
+#include <TDuino.h>
+
+#define SLOTS 240
+#define LOOPS 20000
+
+#ifdef ENABLE_COMPACT_SLOTS
+  #define LAYOUT "compact"
+#else
+  #define LAYOUT "default"
+#endif
+
+//Each slot also uses one bit for its active flag
+#define ACTIVE_BIT 0.125f
+
+const byte ACTIVE_COUNTS[] = { 3, 30, SLOTS };
+
+unsigned long events = 0;
+
+void timerCallback(byte timerIndex)
+{
+  events++;
+}
+
+void timelineCallback(byte slot, float progress)
+{
+  events++;
+}
+
+void report(const __FlashStringHelper *object, byte active, float bytes, unsigned long elapsed)
+{
+  Serial.print(F(LAYOUT ","));
+  Serial.print(object);
+  Serial.print(F(","));
+  Serial.print(SLOTS);
+  Serial.print(F(","));
+  Serial.print(active);
+  Serial.print(F(","));
+  Serial.print(bytes);
+  Serial.print(F(","));
+  Serial.print((elapsed * 1000.0f) / LOOPS);
+  Serial.print(F(","));
+  Serial.println(events);
+}
+
+void benchmarkTimer(byte active)
+{
+  TTimer *timer = new TTimer(timerCallback, SLOTS);
+  timer->loop();
+  
+  //Spread the active slots over the timer, intervals must fit in 16 bits
+  randomSeed(active);
+  for (unsigned int i = 0; i < active; i++)
+    timer->set(i * (SLOTS / active), (i % 10 == 0) ? random(5, 50) : random(1000, 60000), 0);
+  
+  events = 0;
+  unsigned long start = micros();
+  for (unsigned int i = 0; i < LOOPS; i++) timer->loop();
+  report(F("timer"), active, sizeof(TTIMER_SLOT) + ACTIVE_BIT, micros() - start);
+  delete timer;
+}
+
+void benchmarkTimeline(byte active)
+{
+  TTimeline *timeline = new TTimeline(timelineCallback, SLOTS);
+  timeline->loop();
+  
+  randomSeed(active);
+  for (unsigned int i = 0; i < active; i++)
+    timeline->set(i * (SLOTS / active), random(1000, 60000), random(0, 100));
+  
+  events = 0;
+  unsigned long start = micros();
+  for (unsigned int i = 0; i < LOOPS; i++) timeline->loop();
+  report(F("timeline"), active, sizeof(TTIMELINE_SLOT) + ACTIVE_BIT, micros() - start);
+  delete timeline;
+}
+
+void setup()
+{
+  Serial.begin(115200);
+  Serial.println(F("layout,object,slots,active,bytes_per_slot,ns_per_loop,events"));
+  for (byte i = 0; i < sizeof(ACTIVE_COUNTS); i++) benchmarkTimer(ACTIVE_COUNTS[i]);
+  for (byte i = 0; i < sizeof(ACTIVE_COUNTS); i++) benchmarkTimeline(ACTIVE_COUNTS[i]);
+}
+
+void loop()
+{
+}
@@ -0,0 +1,64 @@
+//Required hardware: LED diode, 330 Ohm resistor
+
+//Required wiring:
+//Pin D3 => 330 Ohm => LED anode (LED+, long leg)
+//LED cathode (LED-, short leg) => GND
+
+//Same as the "timer" example, but each timer slot has its own handler
+//so there is no need for a switch in a shared callback.
+
+#include <TDuino.h>
+
+#define NUM_LEDS 2
+#define LED_PWM_PIN 3
+
+const byte LED_PINS[NUM_LEDS] = { LED_BUILTIN, LED_PWM_PIN };
+
+TPin leds[NUM_LEDS];
+TTimer timer(NULL, 3); //Three timer slots, no shared callback
+
+//A handler receives the context given to setHandler()
+void flipLed(void *context, byte timerIndex)
+{
+  ((TPin*)context)->flip();
+}
+
+//A class whose method is used as handler
+class TShow
+{
+public:
+  void restart(byte timerIndex)
+  {
+    timer.restart(1); //Restart second timer slot which has been finished for ~2 seconds.
+  }
+};
+
+TShow show;
+
+void setup()
+{
+   //Attach LED's to pins
+   for (byte i = 0; i < NUM_LEDS; i++) leds[i].attach(LED_PINS[i], OUTPUT);
+   
+   //The same handler is used for both LED's, the context tells which one to flip
+   timer.setHandler(0, flipLed, &leds[0]);
+   timer.setHandler(1, flipLed, &leds[1]);
+   
+   //TDuino_Method calls a method of the object given as context
+   timer.setHandler(2, TDuino_Method<TShow, &TShow::restart>, &show);
+   
+   //Set first timer to 250ms delay and 0 (indefinite) repetitions
+   timer.set(0, 250, 0); 
+   
+   //Set second timer to 500ms delay and 10 repetitions (5 seconds show)
+   timer.set(1, 500, 10);
+   
+   //Set third timer to 7 seconds delay and 0 (indefinite) repetitions
+   timer.set(2, 7000, 0);
+}
+
+void loop()
+{
+  //Loop the timer
+  timer.loop();
+}
@@ -0,0 +1,83 @@
+//Required hardware: None
+
+//Shows how TTIMER_STATS can be used to find the parts of a sketch which are overrunning
+//the loop phase. TTIMER_STATS must be uncommented in TDefs.h (or passed to the compiler
+//when running on a host computer, see extras/host):
+//
+//  g++ -O2 -DARDUINO=100 -DTTIMER_STATS -Iextras/host -I. -x c++ examples/timer_stats/timer_stats.ino -x none *.cpp extras/host/TDuinoHost.cpp -o timer_stats
+//
+//Four "components" are using a slot each. The display is slow and delays the others, so
+//every 5 seconds a report is printed to serial as comma separated lines. Slots which
+//missed periods or whose callback takes more than the loop budget are marked:
+//
+//  slot,fired,missed,late_max,late_mean,run_max,run_mean,overrun
+
+#include <TDuino.h>
+
+#ifndef TTIMER_STATS
+
+void setup()
+{
+  Serial.begin(9600);
+  Serial.println(F("Please uncomment TTIMER_STATS in TDefs.h"));
+}
+
+void loop()
+{
+}
+
+#else
+
+#define LOOP_BUDGET 5000 //Microseconds
+
+const char *names[] = { "led", "sensor", "display", "serial" };
+const unsigned int intervals[] = { 10, 20, 250, 100 };
+const unsigned int workload[] = { 0, 2, 40, 1 }; //Milliseconds spent in each callback
+
+void timerCallback(byte slot)
+{
+  if (workload[slot] > 0) delay(workload[slot]); //Simulates the work of the component
+}
+
+TTimer timer(timerCallback, 4);
+TTimer report(NULL, 1);
+
+void printReport(void *context, byte index)
+{
+  Serial.println(F("slot,fired,missed,late_max,late_mean,run_max,run_mean,overrun"));
+  for (byte i = 0; i < timer.getSize(); i++)
+  {
+    TTimerStats s = timer.getStats(i);
+    Serial.print(names[i]);
+    Serial.print(F(","));
+    Serial.print(s.fired);
+    Serial.print(F(","));
+    Serial.print(s.missed);
+    Serial.print(F(","));
+    Serial.print(s.maxLate);
+    Serial.print(F(","));
+    Serial.print(s.fired ? s.sumLate / s.fired : 0);
+    Serial.print(F(","));
+    Serial.print(s.maxRun);
+    Serial.print(F(","));
+    Serial.print(s.fired ? s.sumRun / s.fired : 0);
+    Serial.println(((s.missed > 0) || (s.maxRun > LOOP_BUDGET)) ? F(",yes") : F(",no"));
+  }
+  timer.resetStats();
+}
+
+void setup()
+{
+  Serial.begin(9600);
+  for (byte i = 0; i < timer.getSize(); i++) timer.set(i, intervals[i], 0);
+  report.setHandler(0, printReport);
+  report.set(5000, 0);
+}
+
+void loop()
+{
+  timer.loop();
+  report.loop();
+}
+
+#endif //TTIMER_STATS
@@ -0,0 +1,65 @@
+//Required hardware: None
+
+//Shows how the timing policies of TTimer handles a stall of the loop phase. Three slots
+//triggers every 100 milliseconds, one using each policy. After 1 second the sketch stalls
+//for 1 second (10 missed periods) and every second the triggers and skipped periods of
+//each slot are printed to serial:
+//
+//  best effort: 10 periods are coalesced into one trigger and the slot drifts
+//  tight:       all the missed periods are triggered in the following loops
+//  capped:      2 of the missed periods are triggered, the rest is skipped
+
+#include <TDuino.h>
+
+#define INTERVAL 100
+
+const char *names[] = { "best effort", "tight", "capped" };
+byte triggers[3];
+
+void timerCallback(byte slot)
+{
+  triggers[slot]++;
+}
+
+TTimer timer(timerCallback, 3);
+bool stalled = false;
+unsigned long lastReport = 0;
+
+void setup()
+{
+  Serial.begin(9600);
+  timer.setTiming(0, TDUINO_TIMING_BEST_EFFORT);
+  timer.setTiming(1, TDUINO_TIMING_TIGHT);
+  timer.setTiming(2, TDUINO_TIMING_CAPPED, 2);
+  for (byte i = 0; i < 3; i++) timer.set(i, INTERVAL, 0);
+}
+
+void loop()
+{
+  timer.loop();
+  
+  if (!stalled && (millis() >= 1050))
+  {
+    Serial.println(F("Stalling for 1000 ms"));
+    delay(1000);
+    stalled = true;
+  }
+  
+  if (millis() - lastReport >= 1000)
+  {
+    lastReport += 1000;
+    for (byte i = 0; i < 3; i++)
+    {
+      Serial.print(lastReport);
+      Serial.print(F(" ms, "));
+      Serial.print(names[i]);
+      Serial.print(F(": triggers="));
+      Serial.print(triggers[i]);
+      Serial.print(F(" counter="));
+      Serial.print(timer.getCounter(i));
+      Serial.print(F(" skipped="));
+      Serial.println(timer.getSkipped(i));
+      triggers[i] = 0;
+    }
+  }
+}
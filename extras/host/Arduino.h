@@ -0,0 +1,173 @@
+/*
+  
+  Copyright © 2018 - Torben Bruchhaus
+  TDuino.bruchhaus.dk - github.com/bswebdk/TDuino
+  File: extras/host/Arduino.h
+  
+  This program is free software: you can redistribute it and/or modify
+  it under the terms of the GNU Lesser General Public License as published
+  by the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+  
+  This program is distributed in the hope that it will be useful, but
+  WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+  Lesser General Public License for more details.
+  
+  You should have received a copy of the GNU Lesser General Public License
+  along with this program.  If not, see <http://www.gnu.org/licenses/>
+  
+*/
+
+//The subset of the Arduino core used by TDuino and its examples, implemented on top
+//of the virtual time base and pin model in TDuinoHost.h. See extras/host/README.md.
+
+#ifndef ARDUINO_H
+#define ARDUINO_H
+
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+
+#define TDUINO_HOST
+
+typedef uint8_t byte;
+typedef bool boolean;
+typedef unsigned int word;
+
+#define HIGH 0x1
+#define LOW  0x0
+
+#define INPUT 0x0
+#define OUTPUT 0x1
+#define INPUT_PULLUP 0x2
+
+#define CHANGE 1
+#define FALLING 2
+#define RISING 3
+
+#define DEC 10
+#define HEX 16
+#define OCT 8
+#define BIN 2
+
+#define PROGMEM
+#define PSTR(s) (s)
+#define pgm_read_byte(addr) (*(const uint8_t*)(addr))
+#define pgm_read_word(addr) (*(const uint16_t*)(addr))
+#define pgm_read_dword(addr) (*(const uint32_t*)(addr))
+
+class __FlashStringHelper;
+#define F(s) ((const __FlashStringHelper*)(s))
+
+#define bit(b) (1UL << (b))
+#define bitRead(value, b) (((value) >> (b)) & 0x01)
+#define bitSet(value, b) ((value) |= (1UL << (b)))
+#define bitClear(value, b) ((value) &= ~(1UL << (b)))
+#define bitWrite(value, b, v) ((v) ? bitSet(value, b) : bitClear(value, b))
+#define constrain(amt, low, high) ((amt) < (low) ? (low) : ((amt) > (high) ? (high) : (amt)))
+
+#define interrupts()
+#define noInterrupts()
+
+#include "pins_arduino.h"
+
+unsigned long millis();
+unsigned long micros();
+void delay(unsigned long ms);
+void delayMicroseconds(unsigned int us);
+
+void pinMode(uint8_t pin, uint8_t mode);
+void digitalWrite(uint8_t pin, uint8_t value);
+int digitalRead(uint8_t pin);
+int analogRead(uint8_t pin);
+void analogWrite(uint8_t pin, int value);
+
+#define NOT_A_PORT 0
+#define PB 2
+#define PC 3
+#define PD 4
+
+#define REG_OUTPUT 0
+#define REG_INPUT 1
+#define REG_MODE 2
+
+/**
+ * \brief Mocked 8 bit port register (PORTx, PINx or DDRx of an AVR).
+ * 
+ * Reading and writing the register reads and writes the pins of the port in the pin
+ * model, so code which uses direct port manipulation can be verified on the host.
+ * Like on the AVR, writing a one to a bit of an input register toggles the output.
+ */
+class THostRegister {
+  
+  uint8_t port, type;
+  
+public:
+  
+  THostRegister(uint8_t port, uint8_t type) : port(port), type(type) {}
+  operator uint8_t() const;
+  THostRegister &operator=(uint8_t value);
+  THostRegister &operator|=(uint8_t value) { return *this = (uint8_t)(*this | value); }
+  THostRegister &operator&=(uint8_t value) { return *this = (uint8_t)(*this & value); }
+  THostRegister &operator^=(uint8_t value) { return *this = (uint8_t)(*this ^ value); }
+  
+};
+
+uint8_t digitalPinToPort(uint8_t pin);
+uint8_t digitalPinToBitMask(uint8_t pin);
+THostRegister *portOutputRegister(uint8_t port);
+THostRegister *portInputRegister(uint8_t port);
+THostRegister *portModeRegister(uint8_t port);
+
+void attachInterrupt(uint8_t interruptNum, void (*isr)(), int mode);
+void detachInterrupt(uint8_t interruptNum);
+
+long map(long x, long inMin, long inMax, long outMin, long outMax);
+void randomSeed(unsigned long seed);
+long random(long howBig);
+long random(long howSmall, long howBig);
+
+/**
+ * \brief Minimal replacement for the Serial object which writes to stdout.
+ */
+class HardwareSerial {
+  
+  void printNumber(unsigned long n, int base);
+  
+public:
+  
+  void begin(unsigned long baud);
+  void end();
+  int available();
+  int read();
+  void flush();
+  size_t write(uint8_t c);
+  operator bool() { return true; }
+  
+  void print(const char *s);
+  void print(const __FlashStringHelper *s);
+  void print(char c);
+  void print(unsigned char n, int base = DEC);
+  void print(int n, int base = DEC);
+  void print(unsigned int n, int base = DEC);
+  void print(long n, int base = DEC);
+  void print(unsigned long n, int base = DEC);
+  void print(double n, int digits = 2);
+  
+  void println();
+  template <typename T> void println(T value) { print(value); println(); }
+  template <typename T> void println(T value, int format) { print(value, format); println(); }
+  
+};
+
+extern HardwareSerial Serial;
+
+//Sketch entry points
+void setup();
+void loop();
+
+#include "TDuinoHost.h"
+
+#endif //ARDUINO_H
@@ -0,0 +1,400 @@
+/*
+  
+  Copyright © 2018 - Torben Bruchhaus
+  TDuino.bruchhaus.dk - github.com/bswebdk/TDuino
+  File: extras/host/TDuinoHost.cpp
+  
+  This program is free software: you can redistribute it and/or modify
+  it under the terms of the GNU Lesser General Public License as published
+  by the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+  
+  This program is distributed in the hope that it will be useful, but
+  WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+  Lesser General Public License for more details.
+  
+  You should have received a copy of the GNU Lesser General Public License
+  along with this program.  If not, see <http://www.gnu.org/licenses/>
+  
+*/
+
+#include "TDuinoHost.h"
+#include <stdio.h>
+#include <time.h>
+#include <map>
+
+#define NUM_INTERRUPTS 2
+
+struct THostInput {
+  byte pin;
+  int value;
+};
+
+static unsigned long long hostTime = 0, realStart = 0;
+static unsigned long loopTime = 100;
+static bool realTime = false, stopped = false;
+static byte pinModes[NUM_DIGITAL_PINS];
+static bool pinDriven[NUM_DIGITAL_PINS]; //False if nothing is connected to the pin
+static int pinOutputs[NUM_DIGITAL_PINS], pinInputs[NUM_DIGITAL_PINS];
+static void (*isrCallbacks[NUM_INTERRUPTS])();
+static int isrModes[NUM_INTERRUPTS];
+static THostPinWrite pinWriteCallback = NULL;
+static THostPinMode pinModeCallback = NULL;
+
+HardwareSerial Serial;
+
+typedef std::multimap<unsigned long long, THostInput> THostSchedule;
+
+static THostSchedule &scheduled()
+{
+  static THostSchedule schedule; //Constructed on first use, inputs may be scheduled by static constructors
+  return schedule;
+}
+
+static unsigned long long hostClock()
+{
+  timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return (unsigned long long)ts.tv_sec * 1000000ULL + ts.tv_nsec / 1000;
+}
+
+static bool validPin(uint8_t &pin, bool analog)
+{
+  if (analog && (pin < NUM_ANALOG_INPUTS)) pin += A0; //analogRead(0) == analogRead(A0)
+  return pin < NUM_DIGITAL_PINS;
+}
+
+static int digitalLevel(uint8_t pin)
+{
+  if (pinModes[pin] == OUTPUT) return pinOutputs[pin] ? HIGH : LOW;
+  if (!pinDriven[pin]) return ((pinModes[pin] == INPUT_PULLUP) || pinOutputs[pin]) ? HIGH : LOW;
+  return pinInputs[pin] ? HIGH : LOW;
+}
+
+static void applyScheduled(unsigned long long until)
+{
+  THostSchedule &schedule = scheduled();
+  while (!schedule.empty() && (schedule.begin()->first <= until))
+  {
+    THostInput input = schedule.begin()->second;
+    if (!realTime && (schedule.begin()->first > hostTime)) hostTime = schedule.begin()->first;
+    schedule.erase(schedule.begin());
+    TDuinoHost::setInput(input.pin, input.value);
+  }
+}
+
+void TDuinoHost::setTime(unsigned long long us)
+{
+  if (realTime) realStart = hostClock() - us;
+  else hostTime = us;
+}
+
+unsigned long long TDuinoHost::getTime()
+{
+  return realTime ? hostClock() - realStart : hostTime;
+}
+
+void TDuinoHost::advance(unsigned long long us)
+{
+  unsigned long long target = getTime() + us;
+  if (realTime)
+  {
+    while (getTime() < target) applyScheduled(getTime());
+  }
+  else
+  {
+    applyScheduled(target);
+    hostTime = target;
+  }
+}
+
+void TDuinoHost::setRealTime(bool enable)
+{
+  unsigned long long t = getTime();
+  realTime = enable;
+  setTime(t);
+}
+
+void TDuinoHost::setLoopTime(unsigned long us)
+{
+  loopTime = us;
+}
+
+void TDuinoHost::setInput(byte pin, int value)
+{
+  if (!validPin(pin, false)) return;
+  int before = digitalLevel(pin);
+  pinInputs[pin] = value;
+  pinDriven[pin] = true;
+  int after = digitalLevel(pin), irq = digitalPinToInterrupt(pin);
+  if ((before == after) || (irq < 0) || !isrCallbacks[irq]) return;
+  if ((isrModes[irq] == CHANGE) || ((isrModes[irq] == RISING) == (after == HIGH))) isrCallbacks[irq]();
+}
+
+void TDuinoHost::scheduleInput(byte pin, int value, unsigned long ms)
+{
+  THostInput input = { pin, value };
+  scheduled().insert(std::make_pair((unsigned long long)ms * 1000ULL, input));
+}
+
+int TDuinoHost::getOutput(byte pin)
+{
+  return validPin(pin, false) ? pinOutputs[pin] : 0;
+}
+
+byte TDuinoHost::getMode(byte pin)
+{
+  return validPin(pin, false) ? pinModes[pin] : INPUT;
+}
+
+void TDuinoHost::onPinWrite(THostPinWrite callback)
+{
+  pinWriteCallback = callback;
+}
+
+void TDuinoHost::onPinMode(THostPinMode callback)
+{
+  pinModeCallback = callback;
+}
+
+void TDuinoHost::reset()
+{
+  for (byte i = 0; i < NUM_DIGITAL_PINS; i++)
+  {
+    pinModes[i] = INPUT;
+    pinOutputs[i] = LOW;
+    pinInputs[i] = 0;
+    pinDriven[i] = false;
+  }
+  for (byte i = 0; i < NUM_INTERRUPTS; i++) isrCallbacks[i] = NULL;
+  scheduled().clear();
+  setTime(0);
+}
+
+unsigned long TDuinoHost::run(unsigned long ms)
+{
+  unsigned long long end = getTime() + (unsigned long long)ms * 1000ULL;
+  unsigned long loops = 0;
+  stopped = false;
+  while (!stopped && (getTime() < end))
+  {
+    loop();
+    loops++;
+    if (!realTime) advance(loopTime);
+  }
+  return loops;
+}
+
+void TDuinoHost::stop()
+{
+  stopped = true;
+}
+
+unsigned long millis()
+{
+  return (unsigned long)(TDuinoHost::getTime() / 1000ULL);
+}
+
+unsigned long micros()
+{
+  return (unsigned long)TDuinoHost::getTime();
+}
+
+void delay(unsigned long ms)
+{
+  TDuinoHost::advance((unsigned long long)ms * 1000ULL);
+}
+
+void delayMicroseconds(unsigned int us)
+{
+  TDuinoHost::advance(us);
+}
+
+void pinMode(uint8_t pin, uint8_t mode)
+{
+  if (!validPin(pin, false)) return;
+  pinModes[pin] = mode;
+  if (mode == INPUT_PULLUP) pinOutputs[pin] = HIGH;
+  else if (mode == INPUT) pinOutputs[pin] = LOW;
+  if (pinModeCallback) pinModeCallback(pin, mode);
+}
+
+void digitalWrite(uint8_t pin, uint8_t value)
+{
+  if (!validPin(pin, false)) return;
+  pinOutputs[pin] = value ? HIGH : LOW;
+  if (pinWriteCallback) pinWriteCallback(pin, pinOutputs[pin], false);
+}
+
+int digitalRead(uint8_t pin)
+{
+  if (!validPin(pin, false)) return LOW;
+  if (realTime) applyScheduled(TDuinoHost::getTime());
+  return digitalLevel(pin);
+}
+
+int analogRead(uint8_t pin)
+{
+  if (!validPin(pin, true)) return 0;
+  if (realTime) applyScheduled(TDuinoHost::getTime());
+  if (!pinDriven[pin]) return 0;
+  return constrain(pinInputs[pin], 0, 1023);
+}
+
+void analogWrite(uint8_t pin, int value)
+{
+  if (!validPin(pin, false)) return;
+  pinOutputs[pin] = constrain(value, 0, 255);
+  if (pinWriteCallback) pinWriteCallback(pin, pinOutputs[pin], true);
+}
+
+static THostRegister hostRegisters[3][5] = {
+  { THostRegister(0, REG_OUTPUT), THostRegister(1, REG_OUTPUT), THostRegister(PB, REG_OUTPUT), THostRegister(PC, REG_OUTPUT), THostRegister(PD, REG_OUTPUT) },
+  { THostRegister(0, REG_INPUT), THostRegister(1, REG_INPUT), THostRegister(PB, REG_INPUT), THostRegister(PC, REG_INPUT), THostRegister(PD, REG_INPUT) },
+  { THostRegister(0, REG_MODE), THostRegister(1, REG_MODE), THostRegister(PB, REG_MODE), THostRegister(PC, REG_MODE), THostRegister(PD, REG_MODE) }
+};
+
+//Same layout as an Uno: D0-D7 = PORTD, D8-D13 = PORTB, A0-A5 = PORTC
+static int portPin(uint8_t port, uint8_t bit)
+{
+  if (port == PD) return bit;
+  if ((port == PB) && (bit < 6)) return bit + 8;
+  if ((port == PC) && (bit < 6)) return bit + A0;
+  return -1;
+}
+
+uint8_t digitalPinToPort(uint8_t pin)
+{
+  if (pin < 8) return PD;
+  if (pin < 14) return PB;
+  return (pin < NUM_DIGITAL_PINS) ? PC : NOT_A_PORT;
+}
+
+uint8_t digitalPinToBitMask(uint8_t pin)
+{
+  if (pin < 8) return 1 << pin;
+  if (pin < 14) return 1 << (pin - 8);
+  return (pin < NUM_DIGITAL_PINS) ? 1 << (pin - A0) : 0;
+}
+
+THostRegister *portOutputRegister(uint8_t port) { return (port <= PD) ? &hostRegisters[REG_OUTPUT][port] : NULL; }
+THostRegister *portInputRegister(uint8_t port) { return (port <= PD) ? &hostRegisters[REG_INPUT][port] : NULL; }
+THostRegister *portModeRegister(uint8_t port) { return (port <= PD) ? &hostRegisters[REG_MODE][port] : NULL; }
+
+THostRegister::operator uint8_t() const
+{
+  uint8_t value = 0;
+  for (uint8_t bit = 0; bit < 8; bit++)
+  {
+    int pin = portPin(port, bit);
+    if (pin < 0) continue;
+    if (type == REG_INPUT) { if (digitalRead(pin)) value |= 1 << bit; }
+    else if (type == REG_MODE) { if (pinModes[pin] == OUTPUT) value |= 1 << bit; }
+    else if (pinOutputs[pin]) value |= 1 << bit;
+  }
+  return value;
+}
+
+THostRegister &THostRegister::operator=(uint8_t value)
+{
+  for (uint8_t bit = 0; bit < 8; bit++)
+  {
+    int pin = portPin(port, bit);
+    if (pin < 0) continue;
+    bool set = value & (1 << bit);
+    if (type == REG_INPUT) { if (set) digitalWrite(pin, pinOutputs[pin] ? LOW : HIGH); } //Toggle
+    else if (type == REG_MODE) { if (set != (pinModes[pin] == OUTPUT)) pinModes[pin] = set ? OUTPUT : INPUT; }
+    else if (set != (pinOutputs[pin] != 0)) digitalWrite(pin, set);
+  }
+  return *this;
+}
+
+void attachInterrupt(uint8_t interruptNum, void (*isr)(), int mode)
+{
+  if (interruptNum >= NUM_INTERRUPTS) return;
+  isrCallbacks[interruptNum] = isr;
+  isrModes[interruptNum] = mode;
+}
+
+void detachInterrupt(uint8_t interruptNum)
+{
+  if (interruptNum < NUM_INTERRUPTS) isrCallbacks[interruptNum] = NULL;
+}
+
+long map(long x, long inMin, long inMax, long outMin, long outMax)
+{
+  return (x - inMin) * (outMax - outMin) / (inMax - inMin) + outMin;
+}
+
+void randomSeed(unsigned long seed)
+{
+  if (seed != 0) srandom(seed);
+}
+
+long random(long howBig)
+{
+  return (howBig == 0) ? 0 : random() % howBig;
+}
+
+long random(long howSmall, long howBig)
+{
+  return (howSmall >= howBig) ? howSmall : random(howBig - howSmall) + howSmall;
+}
+
+void HardwareSerial::printNumber(unsigned long n, int base)
+{
+  char buf[8 * sizeof(long) + 1], *s = &buf[sizeof(buf) - 1];
+  if (base < 2) base = 10;
+  *s = 0;
+  do
+  {
+    char c = n % base;
+    n /= base;
+    *--s = (c < 10) ? c + '0' : c + 'A' - 10;
+  } while (n);
+  fputs(s, stdout);
+}
+
+void HardwareSerial::begin(unsigned long baud) {}
+void HardwareSerial::end() {}
+int HardwareSerial::available() { return 0; }
+int HardwareSerial::read() { return -1; }
+void HardwareSerial::flush() { fflush(stdout); }
+size_t HardwareSerial::write(uint8_t c) { return (putchar(c) == EOF) ? 0 : 1; }
+
+void HardwareSerial::print(const char *s) { fputs(s, stdout); }
+void HardwareSerial::print(const __FlashStringHelper *s) { fputs((const char*)s, stdout); }
+void HardwareSerial::print(char c) { putchar(c); }
+void HardwareSerial::print(unsigned char n, int base) { printNumber(n, base); }
+void HardwareSerial::print(int n, int base) { print((long)n, base); }
+void HardwareSerial::print(unsigned int n, int base) { printNumber(n, base); }
+void HardwareSerial::print(unsigned long n, int base) { printNumber(n, base); }
+void HardwareSerial::print(double n, int digits) { printf("%.*f", digits, n); }
+void HardwareSerial::println() { fputs("\r\n", stdout); }
+
+void HardwareSerial::print(long n, int base)
+{
+  if ((base == DEC) && (n < 0))
+  {
+    putchar('-');
+    printNumber(-n, base);
+  }
+  else printNumber(n, base);
+}
+
+#ifndef TDUINO_HOST_NO_MAIN
+int main(int argc, char **argv)
+{
+  unsigned long ms = 10000;
+  for (int i = 1; i < argc; i++)
+  {
+    if (strcmp(argv[i], "-r") == 0) TDuinoHost::setRealTime(true);
+    else ms = strtoul(argv[i], NULL, 10);
+  }
+  setup();
+  TDuinoHost::run(ms);
+  fflush(stdout);
+  return 0;
+}
+#endif
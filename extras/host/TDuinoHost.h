@@ -0,0 +1,165 @@
+/*
+  
+  Copyright © 2018 - Torben Bruchhaus
+  TDuino.bruchhaus.dk - github.com/bswebdk/TDuino
+  File: extras/host/TDuinoHost.h
+  
+  This program is free software: you can redistribute it and/or modify
+  it under the terms of the GNU Lesser General Public License as published
+  by the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+  
+  This program is distributed in the hope that it will be useful, but
+  WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+  Lesser General Public License for more details.
+  
+  You should have received a copy of the GNU Lesser General Public License
+  along with this program.  If not, see <http://www.gnu.org/licenses/>
+  
+*/
+
+#ifndef TDUINOHOST_H
+#define TDUINOHOST_H
+
+#include "Arduino.h"
+
+/**
+ * \brief Callback used by TDuinoHost::onPinWrite().
+ * 
+ * The arguments are the pin, the value written and whether it was written with analogWrite().
+ */
+typedef void (*THostPinWrite)(byte, int, bool);
+
+/**
+ * \brief Callback used by TDuinoHost::onPinMode().
+ * 
+ * The arguments are the pin and the mode set with pinMode().
+ */
+typedef void (*THostPinMode)(byte, byte);
+
+/**
+ * \brief Controls the emulated board when TDuino is built on a host computer.
+ * 
+ * Time is virtual by default: millis() and micros() only moves when advance() or delay()
+ * is called or when run() finishes an iteration of loop(). Inputs are scripted with
+ * setInput() and scheduleInput(), outputs can be examined with getOutput() or traced
+ * with onPinWrite().
+ * 
+ * \code
+ * void setup()
+ * {
+ *   TDuinoHost::scheduleInput(2, LOW, 1000);  //Press a button after 1 second..
+ *   TDuinoHost::scheduleInput(2, HIGH, 1200); //..and release it 200 ms later
+ *   button.attach(2);
+ * }
+ * \endcode
+ */
+class TDuinoHost {
+  
+public:
+  
+  /**
+   * \brief Set the virtual time.
+   * \param us The time in microseconds since the board was started.
+   * 
+   * Set a time close to 2^32 ms (or 2^32 us if TIMING_WITH_MICROS is used) to test
+   * how a sketch handles rollover.
+   */
+  static void setTime(unsigned long long us);
+  
+  /**
+   * \brief Get the virtual time.
+   * \return The time in microseconds since the board was started.
+   */
+  static unsigned long long getTime();
+  
+  /**
+   * \brief Move the virtual time forward.
+   * \param us The number of microseconds to move.
+   * 
+   * Scheduled inputs which are due within the time span are applied in order.
+   */
+  static void advance(unsigned long long us);
+  
+  /**
+   * \brief Use the clock of the host rather than virtual time.
+   * \param enable True to use real time.
+   * 
+   * Real time is only useful for benchmarks. Scheduled inputs are applied when the
+   * pins are read.
+   */
+  static void setRealTime(bool enable);
+  
+  /**
+   * \brief Set how much the virtual time moves for each iteration of loop().
+   * \param us The number of microseconds (default is 100).
+   */
+  static void setLoopTime(unsigned long us);
+  
+  /**
+   * \brief Set the level of an input pin.
+   * \param pin The pin.
+   * \param value The level (HIGH / LOW) or the analog value (0-1023).
+   * 
+   * Attached interrupts are triggered if the digital level changes.
+   */
+  static void setInput(byte pin, int value);
+  
+  /**
+   * \brief Set the level of an input pin at a given time.
+   * \param pin The pin.
+   * \param value The level (HIGH / LOW) or the analog value (0-1023).
+   * \param ms The virtual time, in milliseconds, when the level should be set.
+   */
+  static void scheduleInput(byte pin, int value, unsigned long ms);
+  
+  /**
+   * \brief Get the value last written to a pin.
+   * \param pin The pin.
+   * \return The value written with digitalWrite() or analogWrite().
+   */
+  static int getOutput(byte pin);
+  
+  /**
+   * \brief Get the mode of a pin.
+   * \param pin The pin.
+   * \return The mode set with pinMode().
+   */
+  static byte getMode(byte pin);
+  
+  /**
+   * \brief Get a callback whenever a pin is written.
+   * \param callback The callback or NULL to disable.
+   */
+  static void onPinWrite(THostPinWrite callback);
+  
+  /**
+   * \brief Get a callback whenever the mode of a pin is set.
+   * \param callback The callback or NULL to disable.
+   * 
+   * Can be used to emulate external hardware which depends on the pin modes, eg. a key
+   * matrix where the active row is the one which is an output.
+   */
+  static void onPinMode(THostPinMode callback);
+  
+  /**
+   * \brief Reset all pins, scheduled inputs and interrupts and set the time to zero.
+   */
+  static void reset();
+  
+  /**
+   * \brief Call loop() until the virtual time has moved a given amount or stop() is called.
+   * \param ms The number of milliseconds to run.
+   * \return The number of times loop() was called.
+   */
+  static unsigned long run(unsigned long ms);
+  
+  /**
+   * \brief Make run() return after the current iteration of loop().
+   */
+  static void stop();
+  
+};
+
+#endif //TDUINOHOST_H
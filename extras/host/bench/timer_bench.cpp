@@ -0,0 +1,122 @@
+/*
+  
+  Copyright © 2018 - Torben Bruchhaus
+  TDuino.bruchhaus.dk - github.com/bswebdk/TDuino
+  File: extras/host/bench/timer_bench.cpp
+  
+  This program is free software: you can redistribute it and/or modify
+  it under the terms of the GNU Lesser General Public License as published
+  by the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+  
+  This program is distributed in the hope that it will be useful, but
+  WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+  Lesser General Public License for more details.
+  
+  You should have received a copy of the GNU Lesser General Public License
+  along with this program.  If not, see <http://www.gnu.org/licenses/>
+  
+*/
+
+//Measures the time spent in TTimer::loop() with 10, 100 and 1000 slots using the
+//scheduling engine selected with the defines. The virtual time moves 1 ms per loop and
+//only the calls to TTimer::loop() are measured (with the clock of the host). Two
+//workloads are used:
+//
+//  dense:  All slots have intervals of 1..20 ms, so many slots are due in every loop.
+//  sparse: 1 in 10 slots has an interval of 5..50 ms, the rest 1 second to 1 hour.
+//
+//Each result is printed as a comma separated line. The number of triggers is checked
+//against the number expected from the intervals, so the program fails if a slot is
+//triggered too often or not at all.
+
+#include "TDuinoHost.h"
+#include "TDuino.h"
+#include <stdio.h>
+#include <time.h>
+
+#define SLOTS_PER_TIMER 250
+#define MAX_TIMERS 4
+#define LOOPS 2000
+
+#if defined(TTIMER_TIMING_WHEEL)
+  #define ENGINE "wheel"
+#elif defined(TTIMER_DEADLINE_ORDER)
+  #define ENGINE "ordered"
+#else
+  #define ENGINE "linear"
+#endif
+
+static const unsigned int SLOT_COUNTS[] = { 10, 100, 1000 };
+
+static TTimer *timers[MAX_TIMERS];
+static unsigned long triggers = 0;
+
+static void timerCallback(byte index)
+{
+  triggers++;
+}
+
+static unsigned long long hostNanos()
+{
+  timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return (unsigned long long)ts.tv_sec * 1000000000ULL + ts.tv_nsec;
+}
+
+static bool benchmark(unsigned int slots, bool dense)
+{
+  byte numTimers = 0;
+  unsigned int i;
+  unsigned long interval, expected = 0;
+  
+  TDuinoHost::reset();
+  while (slots > numTimers * SLOTS_PER_TIMER)
+  {
+    i = slots - (numTimers * SLOTS_PER_TIMER);
+    timers[numTimers++] = new TTimer(timerCallback, (i > SLOTS_PER_TIMER) ? SLOTS_PER_TIMER : i);
+  }
+  
+  randomSeed(slots);
+  for (byte t = 0; t < numTimers; t++)
+  {
+    timers[t]->loop();
+    for (i = 0; i < timers[t]->getSize(); i++)
+    {
+      if (dense) interval = random(1, 21);
+      else interval = (i % 10 == 0) ? random(5, 51) : random(1000, 3600000);
+      timers[t]->set(i, interval, 0);
+      expected += LOOPS / interval;
+    }
+  }
+  
+  triggers = 0;
+  unsigned long long elapsed = 0, start;
+  for (i = 0; i < LOOPS; i++)
+  {
+    TDuinoHost::advance(1000);
+    start = hostNanos();
+    for (byte t = 0; t < numTimers; t++) timers[t]->loop();
+    elapsed += hostNanos() - start;
+  }
+  
+  printf("%s,%s,%u,%u,%.1f,%lu\n", ENGINE, dense ? "dense" : "sparse", slots, LOOPS, (double)elapsed / LOOPS, triggers);
+  while (numTimers > 0) delete timers[--numTimers];
+  if (triggers == expected) return true;
+  printf("  expected %lu triggers\n", expected);
+  return false;
+}
+
+void setup() {}
+void loop() {}
+
+int main()
+{
+  bool ok = true;
+  printf("engine,workload,slots,loops,ns_per_loop,triggers\n");
+  for (byte d = 0; d < 2; d++)
+    for (byte i = 0; i < sizeof(SLOT_COUNTS) / sizeof(SLOT_COUNTS[0]); i++)
+      ok = benchmark(SLOT_COUNTS[i], d == 0) && ok;
+  return ok ? 0 : 1;
+}
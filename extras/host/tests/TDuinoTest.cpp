@@ -0,0 +1,98 @@
+/*
+  
+  Copyright © 2018 - Torben Bruchhaus
+  TDuino.bruchhaus.dk - github.com/bswebdk/TDuino
+  File: extras/host/tests/TDuinoTest.cpp
+  
+  This program is free software: you can redistribute it and/or modify
+  it under the terms of the GNU Lesser General Public License as published
+  by the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+  
+  This program is distributed in the hope that it will be useful, but
+  WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+  Lesser General Public License for more details.
+  
+  You should have received a copy of the GNU Lesser General Public License
+  along with this program.  If not, see <http://www.gnu.org/licenses/>
+  
+*/
+
+#include "TDuinoTest.h"
+#include <stdio.h>
+
+#define MAX_TESTS 64
+
+struct TTEST_ENTRY {
+  const char *name;
+  void (*test)();
+};
+
+static TTEST_ENTRY tests[MAX_TESTS];
+static int testCount = 0;
+static bool failed = false;
+static void (*loopCallback)() = NULL;
+
+void setup() {}
+
+void loop()
+{
+  if (loopCallback) loopCallback();
+}
+
+TDuinoTest::TDuinoTest(const char *name, void (*test)())
+{
+  if (testCount >= MAX_TESTS) return;
+  tests[testCount].name = name;
+  tests[testCount].test = test;
+  testCount++;
+}
+
+void TDuinoTest::onLoop(void (*callback)())
+{
+  loopCallback = callback;
+}
+
+bool TDuinoTest::check(bool ok, const char *expr, const char *file, int line)
+{
+  if (!ok)
+  {
+    printf("  %s:%d: CHECK(%s) failed\n", file, line, expr);
+    failed = true;
+  }
+  return ok;
+}
+
+bool TDuinoTest::checkEqual(long long expected, long long actual, const char *expr, const char *file, int line)
+{
+  if (expected != actual)
+  {
+    printf("  %s:%d: %s is %lld, expected %lld\n", file, line, expr, actual, expected);
+    failed = true;
+  }
+  return expected == actual;
+}
+
+int TDuinoTest::runAll()
+{
+  int failures = 0;
+  for (int i = 0; i < testCount; i++)
+  {
+    TDuinoHost::reset();
+    TDuinoHost::onPinWrite(NULL);
+    TDuinoHost::onPinMode(NULL);
+    loopCallback = NULL;
+    failed = false;
+    tests[i].test();
+    printf("%s %s\n", failed ? "FAIL" : "ok  ", tests[i].name);
+    if (failed) failures++;
+  }
+  printf("%d of %d tests failed\n", failures, testCount);
+  return failures;
+}
+
+int main()
+{
+  return TDuinoTest::runAll() ? 1 : 0;
+}
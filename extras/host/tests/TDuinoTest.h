@@ -0,0 +1,57 @@
+/*
+  
+  Copyright © 2018 - Torben Bruchhaus
+  TDuino.bruchhaus.dk - github.com/bswebdk/TDuino
+  File: extras/host/tests/TDuinoTest.h
+  
+  This program is free software: you can redistribute it and/or modify
+  it under the terms of the GNU Lesser General Public License as published
+  by the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+  
+  This program is distributed in the hope that it will be useful, but
+  WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+  Lesser General Public License for more details.
+  
+  You should have received a copy of the GNU Lesser General Public License
+  along with this program.  If not, see <http://www.gnu.org/licenses/>
+  
+*/
+
+#ifndef TDUINOTEST_H
+#define TDUINOTEST_H
+
+#include "TDuinoHost.h"
+#include "TDuino.h"
+
+/**
+ * \brief Minimal test runner used by the host tests.
+ * 
+ * Tests are declared with TEST() and registered when the program starts. Before each
+ * test the board is reset with TDuinoHost::reset() and the loop hook is cleared. A test
+ * stops at the first failing CHECK() and the program exits with the number of failed
+ * tests, so it can be used directly with ctest.
+ */
+class TDuinoTest {
+  
+public:
+  
+  TDuinoTest(const char *name, void (*test)());
+  
+  /**
+   * \brief Set the function called by loop() when TDuinoHost::run() is used by a test.
+   */
+  static void onLoop(void (*callback)());
+  
+  static bool check(bool ok, const char *expr, const char *file, int line);
+  static bool checkEqual(long long expected, long long actual, const char *expr, const char *file, int line);
+  static int runAll();
+  
+};
+
+#define TEST(name) static void name(); static TDuinoTest name##_test(#name, name); static void name()
+#define CHECK(expr) do { if (!TDuinoTest::check((expr), #expr, __FILE__, __LINE__)) return; } while (0)
+#define CHECK_EQUAL(expected, actual) do { if (!TDuinoTest::checkEqual((long long)(expected), (long long)(actual), #actual, __FILE__, __LINE__)) return; } while (0)
+
+#endif //TDUINOTEST_H
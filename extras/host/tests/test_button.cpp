@@ -0,0 +1,97 @@
+/*
+  
+  Copyright © 2018 - Torben Bruchhaus
+  TDuino.bruchhaus.dk - github.com/bswebdk/TDuino
+  File: extras/host/tests/test_button.cpp
+  
+  This program is free software: you can redistribute it and/or modify
+  it under the terms of the GNU Lesser General Public License as published
+  by the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+  
+  This program is distributed in the hope that it will be useful, but
+  WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+  Lesser General Public License for more details.
+  
+  You should have received a copy of the GNU Lesser General Public License
+  along with this program.  If not, see <http://www.gnu.org/licenses/>
+  
+*/
+
+//Click and long press gestures of TButton use the same times in milliseconds with and
+//without TIMING_WITH_MICROS.
+
+#include "TDuinoTest.h"
+
+#define BUTTON_PIN 5
+
+static byte clickCount;
+static unsigned int longPresses;
+
+static void onClick(byte pin, byte clicks) { clickCount = clicks; }
+static void onLong(byte pin, int state) { longPresses++; }
+
+//Loop the button every millisecond for "ms" milliseconds
+static void runButton(TButton &button, unsigned long ms)
+{
+  for (unsigned long i = 0; i < ms; i++)
+  {
+    TDuinoHost::advance(1000);
+    button.loop();
+  }
+}
+
+static void attachButton(TButton &button)
+{
+  clickCount = 0;
+  longPresses = 0;
+  button.attach(BUTTON_PIN);
+  button.onClick(onClick);
+  button.onLongPress(onLong);
+  TDuinoHost::setInput(BUTTON_PIN, HIGH);
+  runButton(button, 100);
+}
+
+TEST(default_click_window_is_250_ms)
+{
+  TButton button;
+  attachButton(button);
+  for (byte i = 0; i < 2; i++)
+  {
+    TDuinoHost::setInput(BUTTON_PIN, LOW);
+    runButton(button, 100);
+    TDuinoHost::setInput(BUTTON_PIN, HIGH);
+    runButton(button, 200); //Within the click window
+  }
+  CHECK_EQUAL(0, clickCount);
+  runButton(button, 100);
+  CHECK_EQUAL(2, clickCount);
+}
+
+TEST(default_long_press_is_800_ms)
+{
+  TButton button;
+  attachButton(button);
+  TDuinoHost::setInput(BUTTON_PIN, LOW);
+  runButton(button, 750);
+  CHECK_EQUAL(0, longPresses);
+  runButton(button, 100);
+  CHECK_EQUAL(1, longPresses);
+  TDuinoHost::setInput(BUTTON_PIN, HIGH);
+  runButton(button, 500);
+  CHECK_EQUAL(0, clickCount);
+}
+
+TEST(set_click_uses_milliseconds)
+{
+  TButton button;
+  attachButton(button);
+  button.setClick(100, 2000);
+  TDuinoHost::setInput(BUTTON_PIN, LOW);
+  runButton(button, 1500); //Longer than the default long press
+  CHECK_EQUAL(0, longPresses);
+  TDuinoHost::setInput(BUTTON_PIN, HIGH);
+  runButton(button, 150);
+  CHECK_EQUAL(1, clickCount);
+}
@@ -0,0 +1,84 @@
+/*
+  
+  Copyright © 2018 - Torben Bruchhaus
+  TDuino.bruchhaus.dk - github.com/bswebdk/TDuino
+  File: extras/host/tests/test_clock.cpp
+  
+  This program is free software: you can redistribute it and/or modify
+  it under the terms of the GNU Lesser General Public License as published
+  by the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+  
+  This program is distributed in the hope that it will be useful, but
+  WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+  Lesser General Public License for more details.
+  
+  You should have received a copy of the GNU Lesser General Public License
+  along with this program.  If not, see <http://www.gnu.org/licenses/>
+  
+*/
+
+//Clock sources, built with and without ENABLE_OBJECT_CLOCKS.
+
+#include "TDuinoTest.h"
+
+static unsigned int fired;
+
+static void timerCallback(byte index)
+{
+  fired++;
+}
+
+TEST(default_clock_drives_timers)
+{
+  TClockVirtual clock(0xFFFFFF00UL);
+  TTimer timer(timerCallback, 1);
+  TBase::setDefaultClock(&clock);
+  fired = 0;
+  timer.loop();
+  timer.set(0, 100, 0);
+  for (int i = 0; i < 1000; i++)
+  {
+    clock.advance(1);
+    timer.loop();
+  }
+  TBase::setDefaultClock(NULL);
+  CHECK_EQUAL(10, fired); //Across the 32 bit rollover when built with -m32
+}
+
+TEST(cached_clock_only_moves_on_update)
+{
+  TClockCached cached;
+  TDuinoHost::advance(5000);
+  CHECK_EQUAL(0, cached.read());
+  cached.update();
+  CHECK_EQUAL(TClock::hardware(), cached.read());
+  TClockVirtual source(1234);
+  TClockCached other(&source);
+  source.advance(10);
+  CHECK_EQUAL(1234, other.read());
+  other.update();
+  CHECK_EQUAL(1244, other.read());
+}
+
+#ifdef ENABLE_OBJECT_CLOCKS
+TEST(object_clock_overrides_default)
+{
+  TClockVirtual clock(0);
+  TTimer own(timerCallback, 1), shared(timerCallback, 1);
+  own.setClock(&clock);
+  own.loop();
+  shared.loop();
+  own.set(0, 10, 1);
+  shared.set(0, 10, 1);
+  fired = 0;
+  TDuinoHost::advance(10000);
+  own.loop();
+  shared.loop();
+  CHECK_EQUAL(1, fired);
+  clock.advance(10);
+  own.loop();
+  CHECK_EQUAL(2, fired);
+}
+#endif
@@ -0,0 +1,118 @@
+/*
+  
+  Copyright © 2018 - Torben Bruchhaus
+  TDuino.bruchhaus.dk - github.com/bswebdk/TDuino
+  File: extras/host/tests/test_due.cpp
+  
+  This program is free software: you can redistribute it and/or modify
+  it under the terms of the GNU Lesser General Public License as published
+  by the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+  
+  This program is distributed in the hope that it will be useful, but
+  WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+  Lesser General Public License for more details.
+  
+  You should have received a copy of the GNU Lesser General Public License
+  along with this program.  If not, see <http://www.gnu.org/licenses/>
+  
+*/
+
+//nextDueIn() and TBase::earliestDueIn() of timers and buttons.
+
+#include "TDuinoTest.h"
+
+#define BUTTON_PIN 2
+
+static void timerCallback(byte index) {}
+static void buttonCallback(byte pin, int state) {}
+
+TEST(idle_objects_are_not_due)
+{
+  TTimer timer(timerCallback, 2);
+  TButton button;
+  button.attach(BUTTON_PIN);
+  CHECK(button.setInterrupt(true));
+  timer.loop();
+  button.loop();
+  TBase *objects[] = { &timer, button.asBase() };
+  CHECK_EQUAL(TDUINO_NOT_DUE, TBase::earliestDueIn(objects, 2));
+}
+
+TEST(earliest_timer_slot_is_found)
+{
+  TTimer timer(timerCallback, 2);
+  TButton button;
+  button.attach(BUTTON_PIN);
+  CHECK(button.setInterrupt(true));
+  timer.set(0, 100, 0);
+  timer.set(1, 250, 0);
+  timer.loop();
+  button.loop();
+  TBase *objects[] = { &timer, button.asBase() };
+  CHECK_EQUAL(100, TBase::earliestDueIn(objects, 2));
+  TDuinoHost::advance(30000); //Nothing is looped, the elapsed time is subtracted
+  CHECK_EQUAL(70, TBase::earliestDueIn(objects, 2));
+}
+
+TEST(polled_button_is_always_due)
+{
+  TTimer timer(timerCallback, 1);
+  TButton button;
+  button.attach(BUTTON_PIN);
+  timer.set(0, 100, 0);
+  TDuinoHost::advance(1000000);
+  timer.loop();
+  button.loop();
+  TBase *objects[] = { &timer, button.asBase() };
+  CHECK_EQUAL(0, TBase::earliestDueIn(objects, 2));
+}
+
+TEST(pending_edge_is_due_at_once)
+{
+  TButton button;
+  button.attach(BUTTON_PIN);
+  CHECK(button.setInterrupt(true));
+  button.loop();
+  TDuinoHost::setInput(BUTTON_PIN, LOW); //Within the debounce of the start
+  TBase *objects[] = { button.asBase() };
+  CHECK_EQUAL(button.getDebounce(), TBase::earliestDueIn(objects, 1));
+  TDuinoHost::advance(1000000);
+  button.loop(); //The press is handled at 1000
+  TDuinoHost::advance(1000000);
+  TDuinoHost::setInput(BUTTON_PIN, HIGH);
+  CHECK_EQUAL(0, TBase::earliestDueIn(objects, 1));
+}
+
+TEST(long_press_is_due)
+{
+  TButton button;
+  button.attach(BUTTON_PIN);
+  CHECK(button.setInterrupt(true));
+  button.setClick(250, 800);
+  button.onLongPress(buttonCallback);
+  TDuinoHost::advance(1000000);
+  button.loop();
+  TDuinoHost::setInput(BUTTON_PIN, LOW);
+  button.loop(); //The press is handled at 1000
+  TDuinoHost::advance(300000);
+  TBase *objects[] = { button.asBase() };
+  CHECK_EQUAL(500, TBase::earliestDueIn(objects, 1));
+}
+
+TEST(repeat_is_due)
+{
+  TButton button;
+  button.attach(BUTTON_PIN);
+  CHECK(button.setInterrupt(true));
+  button.setRepeat(400, 100);
+  TDuinoHost::advance(1000000);
+  button.loop();
+  TDuinoHost::setInput(BUTTON_PIN, LOW);
+  button.loop();
+  CHECK_EQUAL(400, button.nextDueIn());
+  TDuinoHost::advance(400000);
+  button.loop(); //First repeat
+  CHECK_EQUAL(100, button.nextDueIn());
+}
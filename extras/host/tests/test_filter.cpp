@@ -0,0 +1,164 @@
+/*
+  
+  Copyright © 2018 - Torben Bruchhaus
+  TDuino.bruchhaus.dk - github.com/bswebdk/TDuino
+  File: extras/host/tests/test_filter.cpp
+  
+  This program is free software: you can redistribute it and/or modify
+  it under the terms of the GNU Lesser General Public License as published
+  by the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+  
+  This program is distributed in the hope that it will be useful, but
+  WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+  Lesser General Public License for more details.
+  
+  You should have received a copy of the GNU Lesser General Public License
+  along with this program.  If not, see <http://www.gnu.org/licenses/>
+  
+*/
+
+//The fixed point filters must stay close to the same filters calculated with doubles and
+//the packed storage of TFilterAverageT must give the same averages as int storage.
+//Built with ENABLE_PIN_FILTERS.
+
+#include <math.h>
+#include <stdlib.h>
+#include "TDuinoTest.h"
+
+#define STEPS 2000
+
+//A slow ramp with noise and a few spikes, in the range of analogRead()
+static int signal(int step)
+{
+  int value = 512 + (int)(400 * sin(step / 150.0)) + (int)random(-20, 21);
+  if ((step % 97) == 0) value = (step & 1) ? 1023 : 0;
+  return value;
+}
+
+TEST(ema_matches_reference)
+{
+  for (byte shift = 1; shift <= 8; shift++)
+  {
+    TFilterEMA filter(shift);
+    double ref = 512, maxError = 0;
+    filter.reset(512);
+    randomSeed(shift);
+    for (int step = 0; step < STEPS; step++)
+    {
+      int x = signal(step);
+      ref += (x - ref) / (1 << shift);
+      double error = fabs(filter.update(x) - ref);
+      if (error > maxError) maxError = error;
+    }
+    CHECK(maxError <= 1.5);
+  }
+}
+
+static int compareInt(const void *a, const void *b)
+{
+  return *(const int *)a - *(const int *)b;
+}
+
+TEST(median_matches_reference)
+{
+  for (byte size = 3; size <= TFILTER_MEDIAN_MAX; size += 2)
+  {
+    TFilterMedian filter(size);
+    int window[TFILTER_MEDIAN_MAX], sorted[TFILTER_MEDIAN_MAX];
+    for (byte i = 0; i < size; i++) window[i] = 300;
+    filter.reset(300);
+    randomSeed(size);
+    for (int step = 0; step < STEPS; step++)
+    {
+      int x = signal(step);
+      window[step % size] = x;
+      for (byte i = 0; i < size; i++) sorted[i] = window[i];
+      qsort(sorted, size, sizeof(int), compareInt);
+      int actual = filter.update(x);
+      if (actual != sorted[size / 2])
+      {
+        CHECK_EQUAL(sorted[size / 2], actual);
+      }
+    }
+  }
+}
+
+static void checkIIR(double b0, double b1, double a1, double tolerance)
+{
+  TFilterIIR filter(b0, b1, a1);
+  double y = 0, x1 = 0, maxError = 0;
+  filter.reset(0);
+  randomSeed(1000);
+  for (int step = 0; step < STEPS; step++)
+  {
+    int x = signal(step);
+    y = b0 * x + b1 * x1 - a1 * y;
+    x1 = x;
+    double error = fabs(filter.update(x) - y);
+    if (error > maxError) maxError = error;
+  }
+  CHECK(maxError <= tolerance);
+}
+
+TEST(iir_low_pass_matches_reference)
+{
+  checkIIR(0.25, 0, -0.75, 1.5);
+  checkIIR(0.05, 0, -0.95, 2.5);
+}
+
+TEST(iir_high_pass_matches_reference)
+{
+  checkIIR(0.95, -0.95, -0.95, 2.5);
+}
+
+static int lastValue;
+
+static void onChange(byte pin, int value) { lastValue = value; }
+
+TEST(input_uses_filter)
+{
+  TFilterEMA filter(2);
+  TPinInput input;
+  input.attach(A0);
+  input.onRising(onChange);
+  TDuinoHost::setInput(A0, 100);
+  input.loop();
+  input.setFilter(&filter);
+  CHECK(input.getFilter() == &filter);
+  TDuinoHost::setInput(A0, 500);
+  input.loop();
+  CHECK_EQUAL(200, lastValue); //100 + (500 - 100) / 4
+  input.setFilter(NULL);
+  input.loop();
+  CHECK_EQUAL(500, lastValue);
+}
+
+TEST(packed_average_matches_int_average)
+{
+  TFilterAverageT<16, int> plain;
+  TFilterAverageT<16, TFilterPacked10> packed;
+  TFilterAverageT<5, TFilterPacked10> odd;
+  TFilterAverageT<5, int> oddPlain;
+  plain.reset(1023);
+  packed.reset(1023);
+  odd.reset(1023);
+  oddPlain.reset(1023);
+  randomSeed(42);
+  for (int step = 0; step < STEPS; step++)
+  {
+    int x = constrain(signal(step), 0, 1023);
+    CHECK_EQUAL(plain.update(x), packed.update(x));
+    CHECK_EQUAL(oddPlain.update(x), odd.update(x));
+  }
+}
+
+TEST(packed_buffer_size)
+{
+  //The buffer is the same on all boards, the rest of the filter is not (see sample_memory)
+  CHECK_EQUAL(20, sizeof(TFILTER_BUFFER<16, TFilterPacked10>));
+  CHECK_EQUAL(40, sizeof(TFILTER_BUFFER<32, TFilterPacked10>));
+  CHECK_EQUAL(7, sizeof(TFILTER_BUFFER<5, TFilterPacked10>));
+  CHECK(sizeof(TFilterAverageT<16, TFilterPacked10>) < sizeof(TFilterAverageT<16, uint16_t>));
+}
@@ -0,0 +1,47 @@
+/*
+  
+  Copyright © 2018 - Torben Bruchhaus
+  TDuino.bruchhaus.dk - github.com/bswebdk/TDuino
+  File: extras/host/tests/test_key_matrix.cpp
+  
+  This program is free software: you can redistribute it and/or modify
+  it under the terms of the GNU Lesser General Public License as published
+  by the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+  
+  This program is distributed in the hope that it will be useful, but
+  WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+  Lesser General Public License for more details.
+  
+  You should have received a copy of the GNU Lesser General Public License
+  along with this program.  If not, see <http://www.gnu.org/licenses/>
+  
+*/
+
+//TKeyMatrix before and after attach().
+
+#include "TDuinoTest.h"
+
+static const byte ROW_PINS[] = { 2, 3, 4, 5 };
+static const byte COLUMN_PINS[] = { 6, 7, 8, 9 };
+
+TEST(unattached_matrix_has_no_keys)
+{
+  TKeyMatrix keys;
+  CHECK_EQUAL(0, keys.getSize());
+  CHECK(!keys.isPressed(0));
+  keys.loop();
+  CHECK(!keys.isPressed(0));
+}
+
+TEST(keys_outside_the_matrix_are_not_pressed)
+{
+  TKeyMatrix keys;
+  keys.attach(ROW_PINS, 4, COLUMN_PINS, 4);
+  CHECK_EQUAL(16, keys.getSize());
+  keys.loop();
+  CHECK(!keys.isPressed(0));
+  CHECK(!keys.isPressed(16));
+  CHECK(!keys.isPressed(255));
+}
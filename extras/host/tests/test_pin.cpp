@@ -0,0 +1,78 @@
+/*
+  
+  Copyright © 2018 - Torben Bruchhaus
+  TDuino.bruchhaus.dk - github.com/bswebdk/TDuino
+  File: extras/host/tests/test_pin.cpp
+  
+  This program is free software: you can redistribute it and/or modify
+  it under the terms of the GNU Lesser General Public License as published
+  by the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+  
+  This program is distributed in the hope that it will be useful, but
+  WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+  Lesser General Public License for more details.
+  
+  You should have received a copy of the GNU Lesser General Public License
+  along with this program.  If not, see <http://www.gnu.org/licenses/>
+  
+*/
+
+//A random sequence of TPin operations must give the same pin states as digitalWrite()
+//and analogWrite(). Built without ENABLE_DIRECT_PORT_IO, with it and with it using the
+//read-modify-write flip of MCUs which cannot toggle a pin by writing PINx.
+
+#include "TDuinoTest.h"
+
+static const byte PINS[] = { 2, 3, 9, 13, 14, 6 }; //3, 9 and 6 has PWM
+#define COUNT sizeof(PINS)
+
+TEST(random_sequence_matches_digital_write)
+{
+  TPin pins[COUNT];
+  int expected[COUNT];
+  for (byte i = 0; i < COUNT; i++)
+  {
+    pins[i].attach(PINS[i], OUTPUT);
+    pins[i].off();
+    expected[i] = LOW;
+  }
+  randomSeed(4321);
+  for (int step = 0; step < 5000; step++)
+  {
+    byte i = random(COUNT);
+    int value;
+    switch (random(5))
+    {
+      case 0: pins[i].on(); expected[i] = HIGH; break;
+      case 1: pins[i].off(); expected[i] = LOW; break;
+      case 2: pins[i].flip(); expected[i] = expected[i] ? LOW : HIGH; break;
+      case 3: value = random(2); pins[i].enable(value); expected[i] = value; break;
+      default:
+        if (!pins[i].hasPwm()) continue;
+        value = random(1, 255);
+        pins[i].pwm(value);
+        expected[i] = value;
+        break;
+    }
+    for (byte p = 0; p < COUNT; p++)
+    {
+      CHECK_EQUAL(expected[p], TDuinoHost::getOutput(PINS[p]));
+      CHECK_EQUAL(expected[p] ? HIGH : LOW, pins[p].state());
+    }
+  }
+}
+
+TEST(pins_outside_are_untouched)
+{
+  TPin pin;
+  pin.attach(9, OUTPUT);
+  pinMode(8, OUTPUT);
+  pinMode(10, OUTPUT);
+  digitalWrite(10, HIGH);
+  for (byte i = 0; i < 5; i++) pin.flip();
+  CHECK_EQUAL(HIGH, TDuinoHost::getOutput(9));
+  CHECK_EQUAL(LOW, TDuinoHost::getOutput(8));
+  CHECK_EQUAL(HIGH, TDuinoHost::getOutput(10));
+}
@@ -0,0 +1,109 @@
+/*
+  
+  Copyright © 2018 - Torben Bruchhaus
+  TDuino.bruchhaus.dk - github.com/bswebdk/TDuino
+  File: extras/host/tests/test_pin_group.cpp
+  
+  This program is free software: you can redistribute it and/or modify
+  it under the terms of the GNU Lesser General Public License as published
+  by the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+  
+  This program is distributed in the hope that it will be useful, but
+  WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+  Lesser General Public License for more details.
+  
+  You should have received a copy of the GNU Lesser General Public License
+  along with this program.  If not, see <http://www.gnu.org/licenses/>
+  
+*/
+
+//A random sequence of TPinGroup operations must give the same pin states as doing the
+//same operations pin by pin with digitalWrite(). Built with and without ENABLE_DIRECT_PORT_IO.
+
+#include "TDuinoTest.h"
+
+static const byte PINS[] = { 2, 9, 14, 3, 13, 7, 16, 10, 4, 19 }; //PORTD, PORTB and PORTC mixed
+#define COUNT sizeof(PINS)
+
+static bool samePins(TPinGroup &group, unsigned long expected)
+{
+  for (byte i = 0; i < COUNT; i++)
+  {
+    if ((TDuinoHost::getOutput(PINS[i]) != 0) != ((expected >> i) & 1)) return false;
+  }
+  return group.read() == expected;
+}
+
+TEST(group_is_attached)
+{
+  TPinGroup group;
+  group.attach(PINS, COUNT);
+  CHECK_EQUAL(COUNT, group.getSize());
+  for (byte i = 0; i < COUNT; i++)
+  {
+    CHECK_EQUAL(PINS[i], group.getPin(i));
+    CHECK_EQUAL(OUTPUT, TDuinoHost::getMode(PINS[i]));
+  }
+}
+
+TEST(random_sequence_matches_digital_write)
+{
+  TPinGroup group;
+  group.attach(PINS, COUNT);
+  unsigned long expected = 0, all = (1UL << COUNT) - 1;
+  group.off();
+  CHECK(samePins(group, 0));
+  randomSeed(1234);
+  for (int step = 0; step < 5000; step++)
+  {
+    unsigned long pattern = random(0x10000) & all, mask = random(0x10000) & all;
+    switch (random(5))
+    {
+      case 0: group.write(pattern); expected = pattern; break;
+      case 1: group.write(pattern, mask); expected = (expected & ~mask) | (pattern & mask); break;
+      case 2: group.flip(mask); expected ^= mask; break;
+      case 3: group.on(); expected = all; break;
+      default: group.off(); expected = 0; break;
+    }
+    if (!samePins(group, expected))
+    {
+      CHECK_EQUAL(expected, group.read());
+      CHECK(samePins(group, expected));
+    }
+  }
+}
+
+TEST(pins_outside_the_group_are_untouched)
+{
+  TPinGroup group;
+  group.attach(PINS, COUNT);
+  pinMode(5, OUTPUT);
+  pinMode(8, OUTPUT);
+  pinMode(15, OUTPUT);
+  digitalWrite(5, HIGH);
+  digitalWrite(15, HIGH);
+  group.on();
+  group.flip();
+  group.write(0x2AA);
+  CHECK_EQUAL(HIGH, TDuinoHost::getOutput(5));
+  CHECK_EQUAL(LOW, TDuinoHost::getOutput(8));
+  CHECK_EQUAL(HIGH, TDuinoHost::getOutput(15));
+}
+
+TEST(pwm_is_stopped_by_attach)
+{
+  TPinGroup group;
+  pinMode(9, OUTPUT);
+  analogWrite(9, 100);
+  group.attach(PINS, COUNT);
+  group.on();
+  CHECK_EQUAL(HIGH, TDuinoHost::getOutput(9));
+  group.off();
+  CHECK_EQUAL(LOW, TDuinoHost::getOutput(9));
+  analogWrite(9, 100);
+  group.attach(PINS, COUNT);
+  group.flip();
+  CHECK_EQUAL(LOW, TDuinoHost::getOutput(9));
+}
@@ -0,0 +1,168 @@
+/*
+  
+  Copyright © 2018 - Torben Bruchhaus
+  TDuino.bruchhaus.dk - github.com/bswebdk/TDuino
+  File: extras/host/tests/test_pin_input.cpp
+  
+  This program is free software: you can redistribute it and/or modify
+  it under the terms of the GNU Lesser General Public License as published
+  by the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+  
+  This program is distributed in the hope that it will be useful, but
+  WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+  Lesser General Public License for more details.
+  
+  You should have received a copy of the GNU Lesser General Public License
+  along with this program.  If not, see <http://www.gnu.org/licenses/>
+  
+*/
+
+//Interrupt driven edge capture of TPinInput. The edges are injected with
+//TDuinoHost::scheduleInput() which calls the interrupt handler at the scheduled time.
+
+#include "TDuinoTest.h"
+
+#define IRQ_PIN 2
+
+static unsigned int falls, rises;
+static int lastValue;
+
+static void onFall(byte pin, int value) { falls++; lastValue = value; }
+static void onRise(byte pin, int value) { rises++; lastValue = value; }
+
+static void attachInput(TPinInput &input, unsigned int debounce)
+{
+  falls = rises = 0;
+  lastValue = -1;
+  input.attach(IRQ_PIN, INPUT_PULLUP);
+  input.setDebounce(debounce);
+  input.onFalling(onFall);
+  input.onRising(onRise);
+}
+
+//Loop the input every "step" milliseconds until the time is "ms"
+static void runInput(TPinInput &input, unsigned long ms, unsigned long step)
+{
+  while (millis() < ms)
+  {
+    TDuinoHost::advance(step * 1000);
+    input.loop();
+  }
+}
+
+TEST(interrupt_is_attached)
+{
+  TPinInput input;
+  attachInput(input, 20);
+  CHECK(input.setInterrupt(true));
+  TPinInput analog;
+  analog.attach(A0);
+  CHECK(!analog.setInterrupt(true));
+  CHECK(!input.setInterrupt(false));
+}
+
+TEST(edges_use_interrupt_timestamps)
+{
+  TPinInput input;
+  attachInput(input, 20);
+  CHECK(input.setInterrupt(true));
+  TDuinoHost::scheduleInput(IRQ_PIN, LOW, 160);
+  TDuinoHost::scheduleInput(IRQ_PIN, HIGH, 190);
+  runInput(input, 150, 50);
+  CHECK_EQUAL(0, falls);
+  runInput(input, 200, 50);
+  //Both edges were captured before loop() at 200 and are 30 ms apart, so neither is debounced
+  CHECK_EQUAL(1, falls);
+  CHECK_EQUAL(1, rises);
+  CHECK_EQUAL(HIGH, lastValue);
+}
+
+TEST(bounces_are_debounced)
+{
+  TPinInput input;
+  attachInput(input, 20);
+  CHECK(input.setInterrupt(true));
+  TDuinoHost::scheduleInput(IRQ_PIN, LOW, 100);
+  TDuinoHost::scheduleInput(IRQ_PIN, HIGH, 101);
+  TDuinoHost::scheduleInput(IRQ_PIN, LOW, 103);
+  TDuinoHost::scheduleInput(IRQ_PIN, HIGH, 300);
+  TDuinoHost::scheduleInput(IRQ_PIN, LOW, 305);
+  TDuinoHost::scheduleInput(IRQ_PIN, HIGH, 306);
+  runInput(input, 500, 50);
+  CHECK_EQUAL(1, falls);
+  CHECK_EQUAL(1, rises);
+  CHECK_EQUAL(HIGH, lastValue);
+}
+
+TEST(final_level_survives_overflow)
+{
+  TPinInput input;
+  attachInput(input, 0);
+  CHECK(input.setInterrupt(true));
+  for (byte i = 0; i < 3 * TPININPUT_EDGES + 1; i++) TDuinoHost::scheduleInput(IRQ_PIN, (i & 1) ? HIGH : LOW, 100 + i);
+  runInput(input, 200, 100);
+  CHECK(falls > 0);
+  CHECK(falls + rises < 3 * TPININPUT_EDGES + 1); //Some edges were dropped..
+  CHECK_EQUAL(LOW, lastValue); //..but not the final level
+}
+
+TEST(idle_interrupt_input_is_not_due)
+{
+  TPinInput input;
+  attachInput(input, 20);
+  CHECK(input.setInterrupt(true));
+  runInput(input, 100, 10);
+  CHECK_EQUAL(TDUINO_NOT_DUE, input.nextDueIn());
+  TDuinoHost::setInput(IRQ_PIN, LOW);
+  CHECK_EQUAL(0, input.nextDueIn());
+}
+
+TEST(async_read_accepts_two_samples_and_clears_on_restart)
+{
+  TPinInput input;
+  input.attach(A0);
+  input.setDebounce(10);
+  TDuinoHost::setInput(A0, 100);
+  CHECK(!input.readAsync(1));
+  CHECK(input.readAsync(2));
+  runInput(input, 50, 5);
+  CHECK(input.readReady());
+  CHECK_EQUAL(100, input.getReadResult());
+  CHECK(input.readReady()); //Reading the result does not clear it..
+  CHECK(input.readAsync(2));
+  CHECK(!input.readReady()); //..starting the next reading does
+}
+
+//A clock far away from the hardware clock which counts how often it is read
+class TCountingClock : public TClock
+{
+public:
+  unsigned int reads;
+  TCountingClock() : reads(0) {}
+  virtual unsigned long read() { reads++; return TClock::hardware() + 0x80000000UL; }
+};
+
+TEST(interrupt_does_not_read_the_clock)
+{
+  TCountingClock clock;
+  TBase::setDefaultClock(&clock);
+  TPinInput input;
+  attachInput(input, 20);
+  CHECK(input.setInterrupt(true));
+  runInput(input, 100, 50);
+  TDuinoHost::scheduleInput(IRQ_PIN, LOW, 110);
+  TDuinoHost::scheduleInput(IRQ_PIN, HIGH, 115); //Bounce
+  TDuinoHost::scheduleInput(IRQ_PIN, LOW, 120);
+  TDuinoHost::scheduleInput(IRQ_PIN, HIGH, 145);
+  unsigned int reads = clock.reads;
+  TDuinoHost::advance(50000); //Only the interrupt runs while time advances
+  CHECK_EQUAL(reads, clock.reads);
+  input.loop();
+  TBase::setDefaultClock(NULL);
+  //The edges are mapped to the clock: the bounce is rejected and the rise 35 ms later is not
+  CHECK_EQUAL(1, falls);
+  CHECK_EQUAL(1, rises);
+  CHECK_EQUAL(HIGH, lastValue);
+}
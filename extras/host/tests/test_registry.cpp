@@ -0,0 +1,131 @@
+/*
+  
+  Copyright © 2018 - Torben Bruchhaus
+  TDuino.bruchhaus.dk - github.com/bswebdk/TDuino
+  File: extras/host/tests/test_registry.cpp
+  
+  This program is free software: you can redistribute it and/or modify
+  it under the terms of the GNU Lesser General Public License as published
+  by the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+  
+  This program is distributed in the hope that it will be useful, but
+  WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+  Lesser General Public License for more details.
+  
+  You should have received a copy of the GNU Lesser General Public License
+  along with this program.  If not, see <http://www.gnu.org/licenses/>
+  
+*/
+
+//TBase::loopAll() with ENABLE_LOOP_REGISTRY: nested passes, objects destroyed during a
+//pass and copies of objects.
+
+#include "TDuinoTest.h"
+
+class TCounter : public TBase {
+public:
+  unsigned int loops;
+  void (*hook)(TCounter*);
+  TCounter() { loops = 0; hook = NULL; }
+  virtual void loop()
+  {
+    TBase::loop();
+    loops++;
+    if (hook) hook(this);
+  }
+};
+
+static TCounter *victim;
+
+static void nestOnce(TCounter *counter)
+{
+  counter->hook = NULL;
+  TBase::loopAll();
+}
+
+static void destroyVictim(TCounter *counter)
+{
+  counter->hook = NULL;
+  delete victim;
+  victim = NULL;
+}
+
+static void nestAndDestroy(TCounter *counter)
+{
+  counter->hook = destroyVictim;
+  TBase::loopAll(); //The inner pass calls destroyVictim()
+}
+
+TEST(all_objects_are_looped)
+{
+  TCounter a, b, c;
+  TBase::loopAll();
+  TBase::loopAll();
+  CHECK_EQUAL(2, a.loops);
+  CHECK_EQUAL(2, b.loops);
+  CHECK_EQUAL(2, c.loops);
+}
+
+TEST(nested_pass_continues_outer_pass)
+{
+  TCounter a, b, c;
+  b.hook = nestOnce;
+  TBase::loopAll();
+  CHECK_EQUAL(2, a.loops);
+  CHECK_EQUAL(2, b.loops);
+  CHECK_EQUAL(2, c.loops); //Looped by the inner and the outer pass
+}
+
+TEST(object_destroyed_in_nested_pass)
+{
+  TCounter a, b, c;
+  victim = new TCounter();
+  TCounter d;
+  a.hook = nestAndDestroy; //The inner pass destroys the object after "a" in the outer pass
+  b.hook = NULL;
+  TBase::loopAll();
+  CHECK(victim == NULL);
+  CHECK_EQUAL(2, b.loops);
+  CHECK_EQUAL(2, d.loops);
+}
+
+TEST(copy_joins_the_registry)
+{
+  TCounter a;
+  TCounter b(a);
+  TBase::loopAll();
+  CHECK_EQUAL(1, a.loops);
+  CHECK_EQUAL(1, b.loops);
+}
+
+TEST(assignment_keeps_the_registry)
+{
+  TCounter a, b, c;
+  b = c;
+  a = c;
+  TBase::loopAll();
+  CHECK_EQUAL(1, a.loops);
+  CHECK_EQUAL(1, b.loops);
+  CHECK_EQUAL(1, c.loops);
+}
+
+static unsigned int fired;
+
+static void timerCallback(byte index)
+{
+  fired++;
+}
+
+TEST(timers_are_looped)
+{
+  TTimer timer(timerCallback, 1);
+  fired = 0;
+  timer.set(0, 5, 1);
+  CHECK_EQUAL(5, TBase::earliestDueIn());
+  TDuinoHost::advance(5000);
+  TBase::loopAll();
+  CHECK_EQUAL(1, fired);
+  CHECK_EQUAL(TDUINO_NOT_DUE, TBase::earliestDueIn());
+}
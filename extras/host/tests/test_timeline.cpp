@@ -0,0 +1,75 @@
+/*
+  
+  Copyright © 2018 - Torben Bruchhaus
+  TDuino.bruchhaus.dk - github.com/bswebdk/TDuino
+  File: extras/host/tests/test_timeline.cpp
+  
+  This program is free software: you can redistribute it and/or modify
+  it under the terms of the GNU Lesser General Public License as published
+  by the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+  
+  This program is distributed in the hope that it will be useful, but
+  WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+  Lesser General Public License for more details.
+  
+  You should have received a copy of the GNU Lesser General Public License
+  along with this program.  If not, see <http://www.gnu.org/licenses/>
+  
+*/
+
+//Progress of TTimeline and the TL_Map* helpers.
+
+#include "TDuinoTest.h"
+
+static float floatProgress;
+static unsigned int fixedProgress;
+
+static void floatCallback(byte slot, float progress) { floatProgress = progress; }
+static void fixedCallback(byte slot, unsigned int progress) { fixedProgress = progress; }
+
+TEST(float_helpers_accept_literals)
+{
+  //Integer and double literals must not be ambiguous with the fixed point helpers
+  CHECK_EQUAL(128, TL_MapToInt(0.5, 0, 255));
+  CHECK_EQUAL(255, TL_MapToInt(1, 0, 255));
+  CHECK_EQUAL(0, TL_MapToInt(0, 0, 255));
+  CHECK_EQUAL(20000L, TL_MapToLong(1, 10000L, 20000L));
+  CHECK(TL_MapToFloat(0.5, 1.5f, 6.5f) == 4.0f);
+}
+
+TEST(fixed_helpers_map_the_full_range)
+{
+  CHECK_EQUAL(0, TL_MapFixToInt(0, 0, 255));
+  CHECK_EQUAL(255, TL_MapFixToInt(TL_PROGRESS_MAX, 0, 255));
+  CHECK_EQUAL(128, TL_MapFixToInt(TL_PROGRESS_MAX / 2 + 1, 0, 255));
+  CHECK_EQUAL(0, TL_MapFixToInt(TL_PROGRESS_MAX, 255, 0));
+  CHECK_EQUAL(-1000, TL_MapFixToInt(TL_PROGRESS_MAX, 1000, -1000));
+  CHECK_EQUAL(4000000000UL, TL_MapFixToULong(TL_PROGRESS_MAX, 0, 4000000000UL));
+  CHECK(TL_MapFixToFloat(TL_PROGRESS_MAX, 1.5f, 6.5f) == 6.5f);
+  for (unsigned long p = 0; p <= TL_PROGRESS_MAX; p += 97)
+  {
+    long expected = lround(100000.0 * p / TL_PROGRESS_MAX);
+    long actual = TL_MapFixToLong(p, 0, 100000);
+    CHECK(labs(actual - expected) <= 1);
+  }
+}
+
+TEST(fixed_progress_follows_float_progress)
+{
+  TTimeline floatLine(floatCallback, 1);
+  TTimeline fixedLine(fixedCallback, 1);
+  floatLine.set(0, 1000);
+  fixedLine.set(0, 1000);
+  for (int ms = 1; ms <= 1000; ms++)
+  {
+    TDuinoHost::advance(1000);
+    floatLine.loop();
+    fixedLine.loop();
+    CHECK(fabs(floatProgress - fixedProgress / (float)TL_PROGRESS_MAX) < 0.0001f);
+  }
+  CHECK_EQUAL(TL_PROGRESS_MAX, fixedProgress);
+  CHECK(floatProgress == 1.0f);
+  CHECK(!fixedLine.isActive(0));
+}
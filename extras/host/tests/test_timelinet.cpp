@@ -0,0 +1,82 @@
+/*
+  
+  Copyright © 2018 - Torben Bruchhaus
+  TDuino.bruchhaus.dk - github.com/bswebdk/TDuino
+  File: extras/host/tests/test_timelinet.cpp
+  
+  This program is free software: you can redistribute it and/or modify
+  it under the terms of the GNU Lesser General Public License as published
+  by the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+  
+  This program is distributed in the hope that it will be useful, but
+  WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+  Lesser General Public License for more details.
+  
+  You should have received a copy of the GNU Lesser General Public License
+  along with this program.  If not, see <http://www.gnu.org/licenses/>
+  
+*/
+
+//Values mapped by TTimelineT compared to the exact values.
+
+#include "TDuinoTest.h"
+#include <limits.h>
+
+static byte byteValue;
+static int intValue;
+static long longValue;
+
+static void byteCallback(byte slot, byte value) { byteValue = value; }
+static void intCallback(byte slot, int value) { intValue = value; }
+static void longCallback(byte slot, long value) { longValue = value; }
+
+TEST(byte_values_are_rounded)
+{
+  TTimelineT<byte> line(byteCallback, 1);
+  line.setMinMax(0, 255);
+  line.set(0, 1000);
+  for (int ms = 1; ms <= 1000; ms++)
+  {
+    TDuinoHost::advance(1000);
+    line.loop();
+    long exact = lround(255.0 * ms / 1000.0);
+    CHECK(labs(byteValue - exact) <= 1);
+  }
+  CHECK_EQUAL(255, byteValue);
+}
+
+TEST(descending_int_values)
+{
+  TTimelineT<int> line(intCallback, 1);
+  line.setMinMax(1000, -1000);
+  line.set(0, 3000);
+  for (int ms = 1; ms <= 3000; ms++)
+  {
+    TDuinoHost::advance(1000);
+    line.loop();
+    long exact = lround(1000.0 - 2000.0 * ms / 3000.0);
+    CHECK(labs(intValue - exact) <= 1);
+  }
+  CHECK_EQUAL(-1000, intValue);
+}
+
+TEST(full_long_range)
+{
+  //The full range of a long, 2^32 - 1 on boards and 2^64 - 1 on 64 bit hosts
+  TTimelineT<long> line(longCallback, 1);
+  double low = (double)LONG_MIN, high = (double)LONG_MAX;
+  line.setMinMax(LONG_MIN, LONG_MAX);
+  line.set(0, 1000);
+  for (int ms = 1; ms < 1000; ms++)
+  {
+    TDuinoHost::advance(1000);
+    line.loop();
+    double exact = low + (high - low) * ms / 1000.0;
+    CHECK(fabs(longValue - exact) <= (high - low) / 65536.0); //Progress has 16 bits
+  }
+  TDuinoHost::advance(1000);
+  line.loop();
+  CHECK(longValue == LONG_MAX);
+}
@@ -0,0 +1,203 @@
+/*
+  
+  Copyright © 2018 - Torben Bruchhaus
+  TDuino.bruchhaus.dk - github.com/bswebdk/TDuino
+  File: extras/host/tests/test_timer.cpp
+  
+  This program is free software: you can redistribute it and/or modify
+  it under the terms of the GNU Lesser General Public License as published
+  by the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+  
+  This program is distributed in the hope that it will be useful, but
+  WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+  Lesser General Public License for more details.
+  
+  You should have received a copy of the GNU Lesser General Public License
+  along with this program.  If not, see <http://www.gnu.org/licenses/>
+  
+*/
+
+//Repetitions, stop / restart and the handle lifecycle of TTimer. Built once for each
+//scheduling engine (linear, TTIMER_DEADLINE_ORDER, TTIMER_TIMING_WHEEL, compact slots).
+
+#include "TDuinoTest.h"
+
+#define SLOTS 8
+
+static unsigned int fired[SLOTS];
+static unsigned long firedAt[SLOTS];
+
+static void timerCallback(byte index)
+{
+  fired[index]++;
+  firedAt[index] = millis();
+}
+
+static void clearFired()
+{
+  for (byte i = 0; i < SLOTS; i++) fired[i] = firedAt[i] = 0;
+}
+
+//Advance the virtual time one millisecond at a time and loop the timer
+static void runTimer(TTimer &timer, unsigned long ms)
+{
+  while (ms--)
+  {
+    TDuinoHost::advance(1000);
+    timer.loop();
+  }
+}
+
+TEST(repetitions_are_counted)
+{
+  TTimer timer(timerCallback, SLOTS);
+  clearFired();
+  timer.set(0, 10, 3);
+  timer.set(1, 25, 0);
+  runTimer(timer, 100);
+  CHECK_EQUAL(3, fired[0]);
+  CHECK_EQUAL(30, firedAt[0]);
+  CHECK(!timer.isActive(0));
+  CHECK_EQUAL(4, fired[1]);
+  CHECK(timer.isActive(1));
+  CHECK_EQUAL(1, timer.firstActive());
+}
+
+TEST(first_trigger_after_interval)
+{
+  TTimer timer(timerCallback, SLOTS);
+  clearFired();
+  timer.set(2, 50, 1);
+  runTimer(timer, 49);
+  CHECK_EQUAL(0, fired[2]);
+  runTimer(timer, 1);
+  CHECK_EQUAL(1, fired[2]);
+  runTimer(timer, 200);
+  CHECK_EQUAL(1, fired[2]);
+}
+
+TEST(stop_restart_and_resume)
+{
+  TTimer timer(timerCallback, SLOTS);
+  clearFired();
+  timer.set(0, 10, 0);
+  runTimer(timer, 15);
+  CHECK_EQUAL(1, fired[0]);
+  timer.stop(0);
+  CHECK(!timer.isActive(0));
+  runTimer(timer, 100);
+  CHECK_EQUAL(1, fired[0]);
+  timer.restart(0);
+  runTimer(timer, 9);
+  CHECK_EQUAL(1, fired[0]);
+  runTimer(timer, 1);
+  CHECK_EQUAL(2, fired[0]);
+  timer.stopAll();
+  CHECK_EQUAL(-1, timer.firstActive());
+  timer.resumeAll();
+  CHECK(timer.isActive(0));
+}
+
+TEST(many_slots_fire_in_step)
+{
+  TTimer timer(timerCallback, SLOTS);
+  clearFired();
+  for (byte i = 0; i < SLOTS; i++) timer.set(i, (i + 1) * 7, 0);
+  runTimer(timer, 1000);
+  for (byte i = 0; i < SLOTS; i++) CHECK_EQUAL(1000 / ((i + 1) * 7), fired[i]);
+}
+
+TEST(handles_are_allocated_until_full)
+{
+  TTimer timer(timerCallback, SLOTS);
+  TSlotHandle handles[SLOTS];
+  for (byte i = 0; i < SLOTS; i++)
+  {
+    handles[i] = timer.allocate();
+    CHECK(handles[i].index != TSLOT_NONE);
+    CHECK(timer.isValid(handles[i]));
+  }
+  CHECK_EQUAL(TSLOT_NONE, timer.allocate().index);
+  CHECK(timer.release(handles[3]));
+  TSlotHandle again = timer.allocate();
+  CHECK_EQUAL(handles[3].index, again.index);
+  CHECK(timer.isValid(again));
+  CHECK(!timer.isValid(handles[3]));
+}
+
+TEST(stale_handle_is_ignored)
+{
+  TTimer timer(timerCallback, SLOTS);
+  clearFired();
+  TSlotHandle old = timer.allocate();
+  timer.set(old, 10, 0);
+  CHECK(timer.isActive(old));
+  CHECK(timer.release(old));
+  CHECK(!timer.isActive(old.index));
+  CHECK(!timer.release(old));
+  TSlotHandle next = timer.allocate();
+  CHECK_EQUAL(old.index, next.index);
+  timer.set(next, 10, 0);
+  timer.stop(old);
+  timer.set(old, 1000, 1);
+  CHECK(timer.isActive(next));
+  CHECK(!timer.isActive(old));
+  runTimer(timer, 30);
+  CHECK_EQUAL(3, fired[next.index]);
+}
+
+TEST(stale_handle_survives_many_cycles)
+{
+  TTimer timer(timerCallback, 1);
+  TSlotHandle old = timer.allocate(), next;
+  CHECK(timer.release(old));
+  for (unsigned int i = 0; i < 1000; i++)
+  {
+    next = timer.allocate();
+    CHECK(!timer.isValid(old));
+    CHECK(timer.release(next));
+  }
+}
+
+TEST(active_slots_are_not_allocated)
+{
+  TTimer timer(timerCallback, SLOTS);
+  timer.set(0, 10, 0);
+  timer.set(5, 10, 0);
+  for (byte i = 0; i < SLOTS - 2; i++)
+  {
+    TSlotHandle handle = timer.allocate();
+    CHECK(handle.index != 0);
+    CHECK(handle.index != 5);
+  }
+  CHECK_EQUAL(TSLOT_NONE, timer.allocate().index);
+}
+
+#define MANY 200
+
+static unsigned int manyFired[MANY];
+
+static void manyCallback(byte index)
+{
+  manyFired[index]++;
+}
+
+TEST(many_slots_fire_on_time)
+{
+  //Enough slots with mixed intervals to exercise the ordering of the scheduled engines
+  TTimer timer(manyCallback, MANY);
+  unsigned int i;
+  randomSeed(7);
+  for (i = 0; i < MANY; i++)
+  {
+    manyFired[i] = 0;
+    timer.set(i, 1 + random(60), 0);
+  }
+  runTimer(timer, 300);
+  for (i = 0; i < MANY; i += 2) timer.stop(i); //Remove every other slot from the middle
+  for (i = 0; i < MANY; i++) CHECK_EQUAL(300 / timer.getInterval(i), manyFired[i]);
+  runTimer(timer, 300);
+  for (i = 0; i < MANY; i++) CHECK_EQUAL(((i & 1) ? 600 : 300) / timer.getInterval(i), manyFired[i]);
+}
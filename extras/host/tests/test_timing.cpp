@@ -0,0 +1,119 @@
+/*
+  
+  Copyright © 2018 - Torben Bruchhaus
+  TDuino.bruchhaus.dk - github.com/bswebdk/TDuino
+  File: extras/host/tests/test_timing.cpp
+  
+  This program is free software: you can redistribute it and/or modify
+  it under the terms of the GNU Lesser General Public License as published
+  by the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+  
+  This program is distributed in the hope that it will be useful, but
+  WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+  Lesser General Public License for more details.
+  
+  You should have received a copy of the GNU Lesser General Public License
+  along with this program.  If not, see <http://www.gnu.org/licenses/>
+  
+*/
+
+//Timing policies (TTimer::setTiming()) after a stall of the loop phase.
+
+#include "TDuinoTest.h"
+
+static unsigned int fired;
+
+static void timerCallback(byte index)
+{
+  fired++;
+}
+
+//Stall for "ms" milliseconds and then loop a few times without moving the time
+static void stall(TTimer &timer, unsigned long ms)
+{
+  TDuinoHost::advance(ms * 1000);
+  for (byte i = 0; i < 10; i++) timer.loop();
+}
+
+TEST(best_effort_drops_missed_periods)
+{
+  TTimer timer(timerCallback, 1);
+  timer.setTiming(0, TDUINO_TIMING_BEST_EFFORT);
+  timer.set(0, 10, 0);
+  fired = 0;
+  stall(timer, 55);
+  CHECK_EQUAL(1, fired);
+  CHECK_EQUAL(4, timer.getSkipped(0));
+  stall(timer, 9);
+  CHECK_EQUAL(1, fired); //The period restarted at 55
+  stall(timer, 1);
+  CHECK_EQUAL(2, fired);
+}
+
+TEST(tight_catches_up_every_period)
+{
+  TTimer timer(timerCallback, 1);
+  timer.setTiming(0, TDUINO_TIMING_TIGHT);
+  timer.set(0, 10, 0);
+  fired = 0;
+  stall(timer, 55);
+  CHECK_EQUAL(5, fired);
+  CHECK_EQUAL(0, timer.getSkipped(0));
+  stall(timer, 5);
+  CHECK_EQUAL(6, fired); //Still in phase with the start
+}
+
+TEST(capped_skips_beyond_cap)
+{
+  TTimer timer(timerCallback, 1);
+  timer.setTiming(0, TDUINO_TIMING_CAPPED, 1);
+  timer.set(0, 10, 0);
+  fired = 0;
+  stall(timer, 55);
+  CHECK_EQUAL(2, fired);
+  CHECK_EQUAL(3, timer.getSkipped(0));
+  stall(timer, 5);
+  CHECK_EQUAL(3, fired);
+}
+
+TEST(capped_zero_triggers_once)
+{
+  TTimer timer(timerCallback, 1);
+  timer.setTiming(0, TDUINO_TIMING_CAPPED, 0);
+  timer.set(0, 10, 0);
+  fired = 0;
+  stall(timer, 95);
+  CHECK_EQUAL(1, fired);
+  CHECK_EQUAL(8, timer.getSkipped(0));
+  stall(timer, 5);
+  CHECK_EQUAL(2, fired);
+}
+
+TEST(restart_clears_skipped)
+{
+  TTimer timer(timerCallback, 1);
+  timer.setTiming(0, TDUINO_TIMING_BEST_EFFORT);
+  timer.set(0, 10, 0);
+  stall(timer, 55);
+  CHECK(timer.getSkipped(0) > 0);
+  timer.restart(0);
+  CHECK_EQUAL(0, timer.getSkipped(0));
+}
+
+TEST(zero_interval_skips_nothing)
+{
+  TTimer timer(timerCallback, 1);
+  timer.setTiming(0, TDUINO_TIMING_TIGHT);
+  timer.set(0, 0, 3);
+  fired = 0;
+  stall(timer, 5);
+  CHECK_EQUAL(3, fired);
+  CHECK_EQUAL(0, timer.getSkipped(0));
+  timer.setTiming(0, TDUINO_TIMING_CAPPED, 1);
+  timer.set(0, 0, 3);
+  stall(timer, 5);
+  CHECK_EQUAL(6, fired);
+  CHECK_EQUAL(0, timer.getSkipped(0));
+}